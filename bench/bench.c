@@ -0,0 +1,193 @@
+//   _____  ___________              _______________
+//   __  / / /__  /_  /_____________ __|__  /_  ___/
+//   _  / / /__  /_  __/_  ___/  __ `/__/_ <_  __ \
+//   / /_/ / _  / / /_ _  /   / /_/ /____/ // /_/ /
+//   \____/  /_/  \__/ /_/    \__,_/ /____/ \____/
+// Ultra-36 Rom Switcher for Commodore 128 - sim65 cycle benchmark driver
+// Free for personal use.
+// Commercial use or resale (in whole or part) prohibited without permission.
+// (c) 2025 Lukasz Dziwosz / LukasSoft. All Rights Reserved.
+//
+// Usage under sim65: sim65 -c bench.sim ROUTINE 40|80
+// Runs ROUTINE a fixed number of times at the given screen width and exits.
+// scripts/run_bench.py subtracts the cycles of the "null" routine (start-up,
+// argument parsing, reporting) and divides by the iteration count.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <conio.h>
+#include <c128.h>
+
+// Menu routines under test (src/main.c via bench_menu.c)
+extern unsigned char SCREENW;
+extern int current_screen;
+extern const char *romNames[];
+extern unsigned char rom_count;
+unsigned char load_rom_names(const char *names[]);
+void __fastcall__ display_init(unsigned char vdc_active);
+void reset_rom_view(void);
+void fill_line(unsigned char y, unsigned char color, unsigned char reversed);
+void draw_option(int option_num, int total_count, int is_selected);
+void draw_content_area(const char *title, const char *options[], int count, int selected);
+void send_byte(unsigned char value, unsigned char *port_value);
+
+// src/vdc_fast.s via bench_vdc.s
+void __fastcall__ vdc_set_address(unsigned int address);
+void __fastcall__ vdc_write_run(const unsigned char *src, unsigned char count);
+unsigned char __fastcall__ vdc_verify_run(unsigned char expected,
+                                          unsigned char count);
+void __fastcall__ vdc_fill(unsigned int address, unsigned char value,
+                           unsigned int count);
+void __fastcall__ vdc_copy(unsigned int dest, unsigned int source,
+                           unsigned int count);
+
+// The C versions vdc_fast.s replaced (bench_vdc_ref.c)
+void vdc_block_fill(unsigned int address, unsigned char value,
+                    unsigned int count);
+void vdc_block_copy(unsigned int dest, unsigned int source,
+                    unsigned int count);
+void vdc_write_loop(unsigned int address, const unsigned char *src,
+                    unsigned char count);
+
+// Source row for the stream benchmarks
+static unsigned char row_codes[80];
+
+// src/sid_info_screen.c via bench_sid.c
+void bench_sid_sound_check(unsigned int base);
+
+struct bench_routine {
+    const char *name;
+    unsigned char iterations;
+    void (*run)(void);
+};
+
+static void run_null(void)
+{
+}
+
+static void run_fill_line(void)
+{
+    fill_line(21, COLOR_BLUE, 0);
+}
+
+static void run_draw_option(void)
+{
+    draw_option(3, rom_count, 1);
+}
+
+static void run_draw_content_area(void)
+{
+    draw_content_area("Select ROM bank:", romNames, rom_count, 0);
+}
+
+static void run_send_byte(void)
+{
+    unsigned char port_value = 0xFF;
+
+    send_byte(0xA5, &port_value);
+}
+
+// One page of the VDC RAM test's verify pass; the stub data port holds
+// whatever is in RAM at $D601, so every byte matches
+static void run_vdc_verify_run(void)
+{
+    vdc_verify_run(*(unsigned char *)0xD601, 0);
+}
+
+// Clear the 2K attribute area, as the VDC RAM test and info screen do
+static void run_vdc_fill(void)
+{
+    vdc_fill(0x0800, 0x00, 0x0800);
+}
+
+static void run_vdc_block_fill(void)
+{
+    vdc_block_fill(0x0800, 0x00, 0x0800);
+}
+
+// Move one 80-column row up, as a list scroll does
+static void run_vdc_copy(void)
+{
+    vdc_copy(0x0000, 0x0050, 80);
+}
+
+static void run_vdc_block_copy(void)
+{
+    vdc_block_copy(0x0000, 0x0050, 80);
+}
+
+// Write one 80-column row of screen codes
+static void run_vdc_write_run(void)
+{
+    vdc_set_address(0x0050);
+    vdc_write_run(row_codes, 80);
+}
+
+static void run_vdc_write_loop(void)
+{
+    vdc_write_loop(0x0050, row_codes, 80);
+}
+
+static void run_sid_sound_check(void)
+{
+    bench_sid_sound_check(0xD400);
+}
+
+static const struct bench_routine routines[] = {
+    {"null", 1, run_null},
+    {"fill_line", 16, run_fill_line},
+    {"draw_option", 16, run_draw_option},
+    {"draw_content_area", 2, run_draw_content_area},
+    {"send_byte", 4, run_send_byte},
+    {"vdc_verify_run", 4, run_vdc_verify_run},
+    {"vdc_fill", 16, run_vdc_fill},
+    {"vdc_block_fill", 16, run_vdc_block_fill},
+    {"vdc_copy", 16, run_vdc_copy},
+    {"vdc_block_copy", 16, run_vdc_block_copy},
+    {"vdc_write_run", 4, run_vdc_write_run},
+    {"vdc_write_loop", 4, run_vdc_write_loop},
+    {"play_sid_sound_check", 1, run_sid_sound_check}
+};
+
+#define ROUTINE_COUNT (sizeof(routines) / sizeof(routines[0]))
+
+int main(int argc, char *argv[])
+{
+    const struct bench_routine *routine;
+    unsigned char i;
+    unsigned char n;
+
+    if (argc != 3)
+    {
+        printf("usage: bench.sim ROUTINE 40|80\n");
+        return EXIT_FAILURE;
+    }
+
+    SCREENW = (unsigned char)atoi(argv[2]);
+    if (SCREENW != 40 && SCREENW != 80)
+    {
+        printf("bench: width must be 40 or 80\n");
+        return EXIT_FAILURE;
+    }
+    display_init(SCREENW == 80);
+    current_screen = 0;
+    rom_count = load_rom_names(romNames);
+    reset_rom_view();
+
+    for (i = 0; i < ROUTINE_COUNT; i++)
+    {
+        routine = &routines[i];
+        if (strcmp(routine->name, argv[1]) != 0)
+            continue;
+
+        for (n = 0; n < routine->iterations; n++)
+            routine->run();
+        printf("routine %s width %u iterations %u\n", routine->name,
+               SCREENW, routine->iterations);
+        return EXIT_SUCCESS;
+    }
+
+    printf("bench: unknown routine %s\n", argv[1]);
+    return EXIT_FAILURE;
+}
@@ -0,0 +1,14 @@
+// Ultra-36 Rom Switcher - sim65 benchmark build of the menu program.
+// main.c keeps its own main(); rename it so bench.c owns the entry point.
+
+#define main menu_main
+#include "main.c"
+#undef main
+
+#include "rom_catalog.c"
+#include "name_table.c"
+#include "warm_state.c"
+#include "redraw.c"
+#include "display.c"
+#include "ui_strings.c"
+#include "scheduler.c"
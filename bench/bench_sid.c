@@ -0,0 +1,12 @@
+// Ultra-36 Rom Switcher - sim65 benchmark build of the SID info screen.
+// The sound check normally advances one step per scheduler tick; here the
+// steps run back to back, so the whole phrase is timed without the frames
+// in between.
+
+#include "sid_info_screen.c"
+
+void bench_sid_sound_check(unsigned int base)
+{
+    sid_play_start(base);
+    while (sid_play_step()) {}
+}
@@ -0,0 +1,189 @@
+// Ultra-36 Rom Switcher - sim65 benchmark stubs.
+// sim6502 has no conio, kernal, VIC or VDC. These stand-ins keep a plain
+// 80x25 character/colour buffer so the menu code under test does the same
+// calls as on the C128; their cost is fixed between runs, so the benchmark
+// compares menu-side changes rather than kernal screen output.
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+#include <conio.h>
+#include <c128.h>
+
+#include "vdc_info_screen.h"
+#include "high_rom.h"
+
+#define STUB_STRIDE 80
+#define STUB_ROWS 25
+
+// Read by the ready poll in bench_vdc.s: bit 7 always set
+unsigned char bench_vdc_status = 0x80;
+
+static unsigned char screen[STUB_STRIDE * STUB_ROWS];
+static unsigned char colors[STUB_STRIDE * STUB_ROWS];
+static unsigned char *screen_line = screen;
+static unsigned char *color_line = colors;
+static unsigned char cursor_x;
+static unsigned char cursor_y;
+static unsigned char text_color;
+static unsigned char reverse_mask;
+
+// 40-column display backend (display.c) stand-ins for $0400 and $D800
+unsigned char bench_vic_screen[40 * 25];
+unsigned char bench_vic_colour[40 * 25];
+
+void __fastcall__ gotoxy(unsigned char x, unsigned char y)
+{
+    unsigned int offset = ((unsigned int)y << 6) + ((unsigned int)y << 4);
+
+    cursor_x = x;
+    cursor_y = y;
+    screen_line = screen + offset;
+    color_line = colors + offset;
+}
+
+unsigned char wherex(void)
+{
+    return cursor_x;
+}
+
+unsigned char wherey(void)
+{
+    return cursor_y;
+}
+
+void __fastcall__ cputc(char c)
+{
+    screen_line[cursor_x] = (unsigned char)c | reverse_mask;
+    color_line[cursor_x] = text_color;
+    cursor_x++;
+}
+
+void __fastcall__ cputcxy(unsigned char x, unsigned char y, char c)
+{
+    gotoxy(x, y);
+    cputc(c);
+}
+
+void __fastcall__ cputs(const char *s)
+{
+    while (*s)
+        cputc(*s++);
+}
+
+void __fastcall__ cputsxy(unsigned char x, unsigned char y, const char *s)
+{
+    gotoxy(x, y);
+    cputs(s);
+}
+
+int cprintf(const char *format, ...)
+{
+    char buffer[81];
+    va_list ap;
+    int length;
+
+    va_start(ap, format);
+    length = vsnprintf(buffer, sizeof(buffer), format, ap);
+    va_end(ap);
+    cputs(buffer);
+    return length;
+}
+
+void __fastcall__ cclear(unsigned char length)
+{
+    while (length--)
+        cputc(' ');
+}
+
+void __fastcall__ cclearxy(unsigned char x, unsigned char y, unsigned char length)
+{
+    gotoxy(x, y);
+    cclear(length);
+}
+
+void clrscr(void)
+{
+    memset(screen, ' ', sizeof(screen));
+    gotoxy(0, 0);
+}
+
+char cgetc(void)
+{
+    return CH_ENTER;
+}
+
+unsigned char kbhit(void)
+{
+    return 0;
+}
+
+unsigned char __fastcall__ textcolor(unsigned char color)
+{
+    unsigned char old = text_color;
+
+    text_color = color;
+    return old;
+}
+
+unsigned char __fastcall__ bgcolor(unsigned char color)
+{
+    return color;
+}
+
+unsigned char __fastcall__ bordercolor(unsigned char color)
+{
+    return color;
+}
+
+unsigned char __fastcall__ revers(unsigned char onoff)
+{
+    unsigned char old = reverse_mask != 0;
+
+    reverse_mask = onoff ? 0x80 : 0x00;
+    return old;
+}
+
+void fast(void)
+{
+}
+
+void slow(void)
+{
+}
+
+void c64mode(void)
+{
+}
+
+void* __fastcall__ high_rom_copy(void *dest, const void *src, size_t count)
+{
+    return memcpy(dest, src, count);
+}
+
+unsigned char rom_self_check(void)
+{
+    return 0;
+}
+
+// The F6 VDC page (vdc_info_screen.c) is deliberately left out of the
+// benchmark; main.c only needs these to link. Not measured here:
+// - draw_vdc_info_screen(): the page layout and the one-off 64K probe,
+//   which runs once per power-on and then comes from warm_state
+// - draw_vdc_ram_test_busy(): a single "testing" line
+// - run_vdc_ram_test(): the whole RAM test. It waits for the VDC's own
+//   block fills and copies, which sim65 cannot time; its CPU-side parts
+//   are the vdc_fill, vdc_copy and vdc_verify_run entries in bench.c.
+void draw_vdc_info_screen(unsigned char screen_width)
+{
+    (void)screen_width;
+}
+
+void draw_vdc_ram_test_busy(unsigned char screen_width)
+{
+    (void)screen_width;
+}
+
+void run_vdc_ram_test(void)
+{
+}
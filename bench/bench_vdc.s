@@ -0,0 +1,8 @@
+;
+; Ultra-36 Rom Switcher - sim65 benchmark build of vdc_fast.s
+; The status poll reads _bench_vdc_status (bench_stubs.c) instead of $D600.
+;
+
+BENCH = 1
+
+    .include    "vdc_fast.s"
@@ -0,0 +1,79 @@
+// Ultra-36 Rom Switcher - sim65 benchmark reference for vdc_fast.s.
+// The C block fill/copy and per-byte register writes that vdc_fast.s
+// replaced, kept as the "before" side of the vdc_fill, vdc_copy and
+// vdc_write_run benchmarks. The ready poll reads bench_vdc_status, as the
+// one in bench_vdc.s does.
+
+#include <c128.h>
+
+#define VDC_REG_HIGH_ADDR   18
+#define VDC_REG_LOW_ADDR    19
+#define VDC_REG_VSCROLL     24
+#define VDC_REG_WORD_COUNT  30
+#define VDC_REG_DATA        31
+#define VDC_REG_BLOCK_SRC_HI 32
+#define VDC_REG_BLOCK_SRC_LO 33
+
+#define VDC_BLOCK_COPY      0x80
+#define VDC_BLOCK_CHUNK     255
+
+extern unsigned char bench_vdc_status;
+
+static void ref_vdc_write(unsigned char reg, unsigned char value) {
+    VDC.ctrl = reg;
+    while (!(bench_vdc_status & 0x80));
+    VDC.data = value;
+}
+
+static unsigned char ref_vdc_read(unsigned char reg) {
+    VDC.ctrl = reg;
+    while (!(bench_vdc_status & 0x80));
+    return VDC.data;
+}
+
+static void ref_vdc_set_address(unsigned int address) {
+    ref_vdc_write(VDC_REG_HIGH_ADDR, (unsigned char)(address >> 8));
+    ref_vdc_write(VDC_REG_LOW_ADDR, (unsigned char)address);
+}
+
+void vdc_block_fill(unsigned int address, unsigned char value,
+                    unsigned int count) {
+    unsigned char chunk;
+
+    ref_vdc_write(VDC_REG_VSCROLL,
+                  ref_vdc_read(VDC_REG_VSCROLL) & (unsigned char)~VDC_BLOCK_COPY);
+    ref_vdc_set_address(address);
+    ref_vdc_write(VDC_REG_DATA, value);
+    --count;
+    while (count != 0) {
+        chunk = count > VDC_BLOCK_CHUNK ? VDC_BLOCK_CHUNK : (unsigned char)count;
+        ref_vdc_write(VDC_REG_WORD_COUNT, chunk);
+        count -= chunk;
+    }
+}
+
+void vdc_block_copy(unsigned int dest, unsigned int source,
+                    unsigned int count) {
+    unsigned char mode;
+    unsigned char chunk;
+
+    mode = ref_vdc_read(VDC_REG_VSCROLL);
+    ref_vdc_write(VDC_REG_VSCROLL, mode | VDC_BLOCK_COPY);
+    ref_vdc_set_address(dest);
+    ref_vdc_write(VDC_REG_BLOCK_SRC_HI, (unsigned char)(source >> 8));
+    ref_vdc_write(VDC_REG_BLOCK_SRC_LO, (unsigned char)source);
+    while (count != 0) {
+        chunk = count > VDC_BLOCK_CHUNK ? VDC_BLOCK_CHUNK : (unsigned char)count;
+        ref_vdc_write(VDC_REG_WORD_COUNT, chunk);
+        count -= chunk;
+    }
+    ref_vdc_write(VDC_REG_VSCROLL, mode & (unsigned char)~VDC_BLOCK_COPY);
+}
+
+// One vdc_write() per byte through the auto-incrementing data register
+void vdc_write_loop(unsigned int address, const unsigned char *src,
+                    unsigned char count) {
+    ref_vdc_set_address(address);
+    while (count--)
+        ref_vdc_write(VDC_REG_DATA, *src++);
+}
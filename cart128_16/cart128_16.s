@@ -5,11 +5,14 @@
 
     .export     _exit
     .export     __STARTUP__ : absolute = 1      ; Mark as startup
+    .export     _high_rom_copy, _rom_self_check
     .import     initlib, donelib
     .import     zerobss
     .import     callmain, pushax, _puts, _cgetc, _memcpy, push0
+    .import     _rom_crc, _vdc_rgbi
     .import     RESTOR, BSOUT, CLRCH
-    .import     __RAM_START__, __RAM_SIZE__
+    .import     __CSTACK_START__, __CSTACK_SIZE__
+    .import     stack_paint
     .import     __DATA_LOAD__, __DATA_RUN__, __DATA_SIZE__
     .importzp   ST
 
@@ -25,6 +28,12 @@
 
 CART_MODE = $FF    ; Autostart flag for cartridge
 
+; rom_self_check() results, shown as border colour on failure (rom_check.h)
+ROM_CHECK_OK    = 0
+ROM_CHECK_LOWER = 2     ; Red
+
+VDC_REG_COLORS  = 26    ; Foreground/background colour
+
 ; ------------------------------------------------------------------------
 ; Cartridge header and startup code
 
@@ -96,7 +105,8 @@ L1: lda     sp,x
     dex
     bpl     L1
 
-    ; Initialize BASIC system
+    ; Initialize BASIC system. Both vectors run the full kernal init; the
+    ; menu state survives in RAM and is restored from it (warm_state.c).
     jsr     $FF8A           ; RESTOR - Restore Kernal Vectors
     jsr     $FF84           ; IOINIT - Init I/O Devices
     jsr     $FF81           ; CINT - Init Editor & Video Chips
@@ -123,9 +133,9 @@ L1: lda     sp,x
     stx     spsave          ; Save the system stack pointer
     
     ; Set up argument stack pointer
-    lda    #<(__RAM_START__ + __RAM_SIZE__)
+    lda    #<(__CSTACK_START__ + __CSTACK_SIZE__)
     sta sp
-    lda #>(__RAM_START__ + __RAM_SIZE__)
+    lda #>(__CSTACK_START__ + __CSTACK_SIZE__)
     sta sp+1
 
     ; Copy initialized data from ROM to RAM
@@ -141,6 +151,26 @@ L1: lda     sp,x
     
     ; Call module constructors
     jsr     initlib
+
+    ; Verify the image before any of it runs from C. This is done at 2 MHz
+    ; with the VIC display blanked, which keeps it to a fraction of a second.
+    lda     VIC_CTRL1
+    pha
+    and     #%11101111      ; Display off
+    sta     VIC_CTRL1
+    lda     #1
+    sta     VIC_CLK_128     ; 2 MHz
+    jsr     _rom_self_check
+    tay
+    lda     #0
+    sta     VIC_CLK_128     ; 1 MHz
+    pla
+    sta     VIC_CTRL1
+    tya
+    bne     rom_check_failed
+
+    ; Mark the free stack space for the high-water marks (stack_usage.s)
+    jsr     stack_paint
     
     ; Call main function
     jsr     callmain
@@ -178,10 +208,59 @@ L2: lda     zpsave,x
     ; For now we will restart the program while I investigate, it could be CC65 issue
     jmp warmstart
 
+; The 16K build has no upper ROM: its HIRODATA is linked into the same bank,
+; so high_rom_copy() is a plain memcpy().
+
+_high_rom_copy:
+    jmp     _memcpy
+
+; unsigned char rom_self_check(void)
+; Recompute the CRC of the bank and compare it with the one rom_patch.py
+; sealed at $BFFE.
+
+_rom_self_check:
+    lda     #<$8000
+    ldx     #>$8000
+    jsr     pushax
+    lda     #<(rom_crc_sealed - $8000)
+    ldx     #>(rom_crc_sealed - $8000)
+    jsr     _rom_crc
+    cmp     rom_crc_sealed
+    bne     @bad
+    cpx     rom_crc_sealed+1
+    bne     @bad
+    lda     #ROM_CHECK_OK
+    .byte   $2C             ; Skip the next load
+@bad:
+    lda     #ROM_CHECK_LOWER
+    ldx     #0
+    rts
+
+; ------------------------------------------------------------------------
+; The image does not match its sealed CRC. Show the code in A as VIC border
+; and VDC background colour and stop, rather than run damaged code.
+
+rom_check_failed:
+    sta     VIC_BORDERCOLOR
+    tax
+    lda     _vdc_rgbi,x
+    ldx     #VDC_REG_COLORS
+    stx     VDC_INDEX
+:   bit     VDC_INDEX
+    bpl     :-
+    sta     VDC_DATA
+:   jmp     :-
+
 ; ------------------------------------------------------------------------
 ; Data
 
-.segment        "INIT"
+; Bank CRC, written by "rom_patch.py seal"
+.segment        "ROMCRC"
+
+rom_crc_sealed: .word   $0000
+
+; Kept out of BSS, which is cleared after the zero page has been saved
+.segment        "ZPSAVE"
 
 zpsave: .res    zpspace
 
@@ -6,11 +6,14 @@
     .export     _exit
     .export     __STARTUP__ : absolute = 1      ; Mark as startup
     .export     _enable_high_rom, _disable_high_rom  ; Export ROM bank switching functions
+    .export     _high_rom_copy, _rom_self_check
     .import     initlib, donelib
     .import     zerobss
     .import     callmain, pushax, _puts, _cgetc, _memcpy, push0
+    .import     _rom_crc, _vdc_rgbi
     .import     RESTOR, BSOUT, CLRCH
-    .import     __RAM_START__, __RAM_SIZE__
+    .import     __CSTACK_START__, __CSTACK_SIZE__
+    .import     stack_paint
     .import     __DATA_LOAD__, __DATA_RUN__, __DATA_SIZE__
     .importzp   ST
 
@@ -26,6 +29,13 @@
 
 CART_MODE = $FF    ; Autostart flag for cartridge
 
+; rom_self_check() results, shown as border colour on failure (rom_check.h)
+ROM_CHECK_OK    = 0
+ROM_CHECK_LOWER = 2     ; Red
+ROM_CHECK_UPPER = 8     ; Orange
+
+VDC_REG_COLORS  = 26    ; Foreground/background colour
+
 ; ------------------------------------------------------------------------
 ; Cartridge header and startup code
 
@@ -69,10 +79,6 @@ warmstart:
     
     ; We're running from external cartridge position (32K)
 setup_external_32k:
-    ; Store ROM type for later use
-    lda #0
-    sta romtype             ; 0 = external
-    
     ; Configure MMU for 32K external cartridge operation
     ; BIT 0   : $D000-$DFFF (0 = I/O Block)
     ; BIT 1   : $4000-$7FFF (1 = RAM)
@@ -84,10 +90,6 @@ setup_external_32k:
     jmp     continue_setup
 
 setup_internal_32k:
-    ; Store ROM type for later use
-    lda #1
-    sta romtype             ; 1 = internal
-    
     ; Configure MMU for 32K internal function ROM operation
     ; BIT 0   : $D000-$DFFF (0 = I/O Block)
     ; BIT 1   : $4000-$7FFF (1 = RAM)
@@ -105,7 +107,8 @@ L1: lda     sp,x
     dex
     bpl     L1
 
-    ; Initialize BASIC system
+    ; Initialize BASIC system. Both vectors run the full kernal init; the
+    ; menu state survives in RAM and is restored from it (warm_state.c).
     jsr     $FF8A           ; RESTOR - Restore Kernal Vectors
     jsr     $FF84           ; IOINIT - Init I/O Devices
     jsr     $FF81           ; CINT - Init Editor & Video Chips
@@ -128,13 +131,24 @@ L1: lda     sp,x
     pla                     ; Get MMU setting
     sta     mmusave
 
+    ; Store ROM type for later use. This has to come after zerobss, which
+    ; would otherwise clear it again.
+    lda     MMU_CR
+    and     #%00001100      ; Isolate bits 2-3 ($8000-$BFFF mapping)
+    cmp     #%00000100      ; Internal function ROM (01)?
+    beq     :+
+    lda     #0              ; 0 = external
+    beq     :++
+:   lda     #1              ; 1 = internal
+:   sta     romtype
+
     tsx
     stx     spsave          ; Save the system stack pointer
     
     ; Set up argument stack pointer
-    lda    #<(__RAM_START__ + __RAM_SIZE__)
+    lda    #<(__CSTACK_START__ + __CSTACK_SIZE__)
     sta sp
-    lda #>(__RAM_START__ + __RAM_SIZE__)
+    lda #>(__CSTACK_START__ + __CSTACK_SIZE__)
     sta sp+1
 
     ; Copy initialized data from ROM to RAM
@@ -150,6 +164,26 @@ L1: lda     sp,x
     
     ; Call module constructors
     jsr     initlib
+
+    ; Verify the image before any of it runs from C. This is done at 2 MHz
+    ; with the VIC display blanked, which keeps it to a fraction of a second.
+    lda     VIC_CTRL1
+    pha
+    and     #%11101111      ; Display off
+    sta     VIC_CTRL1
+    lda     #1
+    sta     VIC_CLK_128     ; 2 MHz
+    jsr     _rom_self_check
+    tay
+    lda     #0
+    sta     VIC_CLK_128     ; 1 MHz
+    pla
+    sta     VIC_CTRL1
+    tya
+    bne     rom_check_failed
+
+    ; Mark the free stack space for the high-water marks (stack_usage.s)
+    jsr     stack_paint
     
     ; Call main function
     jsr     callmain
@@ -225,10 +259,85 @@ _disable_high_rom:
     pla
     rts
 
+; void* __fastcall__ high_rom_copy(void *dest, const void *src, size_t count)
+; memcpy() with the upper ROM mapped in. The kernal (and its IRQ handler) is
+; banked out meanwhile, so interrupts stay off for the copy.
+
+_high_rom_copy:
+    php
+    sei
+    jsr     _enable_high_rom
+    jsr     _memcpy         ; Returns dest in A/X, kept by disable/plp
+    jsr     _disable_high_rom
+    plp
+    rts
+
+; unsigned char rom_self_check(void)
+; Recompute the CRC of each 16K half and compare it with the one rom_patch.py
+; sealed at $FEFC. The CRCs live in the upper ROM, which stays mapped in (and
+; interrupts off) for the whole check.
+
+_rom_self_check:
+    php
+    sei
+    jsr     _enable_high_rom
+    lda     #<$8000
+    ldx     #>$8000
+    jsr     pushax
+    lda     #<$4000
+    ldx     #>$4000
+    jsr     _rom_crc
+    cmp     rom_crc_sealed
+    bne     @lower_bad
+    cpx     rom_crc_sealed+1
+    bne     @lower_bad
+    lda     #<$C000
+    ldx     #>$C000
+    jsr     pushax
+    lda     #<(rom_crc_sealed - $C000)
+    ldx     #>(rom_crc_sealed - $C000)
+    jsr     _rom_crc
+    cmp     rom_crc_sealed+2
+    bne     @upper_bad
+    cpx     rom_crc_sealed+3
+    bne     @upper_bad
+    lda     #ROM_CHECK_OK
+    .byte   $2C             ; Skip the next two loads
+@lower_bad:
+    lda     #ROM_CHECK_LOWER
+    .byte   $2C
+@upper_bad:
+    lda     #ROM_CHECK_UPPER
+    ldx     #0
+    jsr     _disable_high_rom
+    plp
+    rts
+
+; ------------------------------------------------------------------------
+; The image does not match its sealed CRC. Show the code in A as VIC border
+; and VDC background colour and stop, rather than run damaged code.
+
+rom_check_failed:
+    sta     VIC_BORDERCOLOR
+    tax
+    lda     _vdc_rgbi,x
+    ldx     #VDC_REG_COLORS
+    stx     VDC_INDEX
+:   bit     VDC_INDEX
+    bpl     :-
+    sta     VDC_DATA
+:   jmp     :-
+
 ; ------------------------------------------------------------------------
 ; Data
 
-.segment        "INIT"
+; Lower and upper half CRC, written by "rom_patch.py seal"
+.segment        "ROMCRC"
+
+rom_crc_sealed: .word   $0000, $0000
+
+; Kept out of BSS, which is cleared after the zero page has been saved
+.segment        "ZPSAVE"
 
 zpsave: .res    zpspace
 
@@ -0,0 +1,281 @@
+#!/usr/bin/env python3
+"""Decode a User Port VCD trace into Ultra-36 commands and check its timing."""
+
+import argparse
+import json
+import sys
+from pathlib import Path
+
+
+TIME_UNITS = {"s": 1e6, "ms": 1e3, "us": 1.0, "ns": 1e-3, "ps": 1e-6, "fs": 1e-9}
+
+# Command byte prefixes built by link_prepare() (src/main.c)
+COMMANDS = {
+    0xA0: "bank {}",
+    0xB0: "jiffy {}",
+    0xC0: "bank high {}",
+    0xD0: "temp bank {}",
+    0xE0: "half {}",
+}
+
+SPEC_KEYS = (
+    "min_setup_us",
+    "min_hold_us",
+    "min_half_period_us",
+    "max_half_period_us",
+    "max_jitter_us",
+    "max_release_wait_us",
+    "max_ack_latency_us",
+)
+
+
+def parse_args():
+    parser = argparse.ArgumentParser()
+    parser.add_argument("trace", type=Path, help="VCD from ultra36-harness -v")
+    parser.add_argument("--spec", required=True, type=Path)
+    parser.add_argument("--json", type=Path, help="also write the frames as JSON")
+    return parser.parse_args()
+
+
+def read_vcd(path):
+    """Return the timescale in microseconds and (time, signal, value) changes."""
+    tokens = path.read_text().split()
+    names = {}
+    scale = 1e-3
+    changes = []
+    time = 0
+    i = 0
+    while i < len(tokens):
+        token = tokens[i]
+        if token == "$var":
+            names[tokens[i + 3]] = tokens[i + 4]
+            i = tokens.index("$end", i) + 1
+        elif token == "$timescale":
+            end = tokens.index("$end", i)
+            text = "".join(tokens[i + 1 : end])
+            digits = text.rstrip("munpfs")
+            scale = int(digits) * TIME_UNITS[text[len(digits) :]]
+            i = end + 1
+        elif token in ("$dumpvars", "$dumpall", "$dumpon", "$dumpoff", "$end"):
+            i += 1
+        elif token.startswith("$"):
+            i = tokens.index("$end", i) + 1
+        elif token.startswith("#"):
+            time = int(token[1:])
+            i += 1
+        elif token[0] in "bB":
+            value = token[1:]
+            if tokens[i + 1] in names and set(value) <= {"0", "1"}:
+                changes.append((time, names[tokens[i + 1]], int(value, 2)))
+            i += 2
+        else:
+            if token[1:] in names and token[0] in "01":
+                changes.append((time, names[token[1:]], int(token[0])))
+            i += 1
+    if not changes:
+        raise ValueError(f"{path} has no value changes")
+    return scale, changes
+
+
+def grouped(changes):
+    """Yield (time, {signal: value}, read_count) per timestamp."""
+    index = 0
+    while index < len(changes):
+        time = changes[index][0]
+        group = {}
+        reads = 0
+        while index < len(changes) and changes[index][0] == time:
+            _, name, value = changes[index]
+            if name == "read":
+                reads += 1
+            elif name != "write":
+                group[name] = value
+            index += 1
+        yield time, group, reads
+
+
+def new_frame(start):
+    return {
+        "start": start,
+        "bits": [],
+        "setup": [],
+        "hold": [],
+        "low": [],
+        "high": [],
+        "last_data": start,
+        "last_rise": None,
+        "last_fall": None,
+        "hold_open": False,
+        "release": None,
+        "release_seen": None,
+        "ack": None,
+        "ack_seen": None,
+    }
+
+
+def decode(changes, scale):
+    level = {"data": 1, "clock": 1, "data_out": 0, "clock_out": 0,
+             "tiny_ack": 0, "prb_read": 0xFF}
+    frames = []
+    frame = None
+
+    for raw_time, group, reads in grouped(changes):
+        time = raw_time * scale
+        before = dict(level)
+        level.update(group)
+        driving = level["data_out"] and level["clock_out"]
+
+        if frame is None:
+            if driving and not (before["data_out"] and before["clock_out"]):
+                frame = new_frame(time)
+            continue
+
+        if frame["release"] is None:
+            if level["data"] != before["data"]:
+                if frame["hold_open"]:
+                    frame["hold"].append(time - frame["last_rise"])
+                    frame["hold_open"] = False
+                frame["last_data"] = time
+            if driving and level["clock"] and not before["clock"]:
+                frame["bits"].append(level["data"])
+                frame["setup"].append(time - frame["last_data"])
+                if frame["last_fall"] is not None:
+                    frame["low"].append(time - frame["last_fall"])
+                frame["last_rise"] = time
+                frame["hold_open"] = True
+            if not level["clock"] and before["clock"]:
+                if frame["last_rise"] is not None:
+                    frame["high"].append(time - frame["last_rise"])
+                frame["last_fall"] = time
+            if before["data_out"] and not level["data_out"] and level["clock_out"]:
+                frame["release"] = time
+                if frame["hold_open"]:
+                    frame["hold"].append(time - frame["last_rise"])
+        else:
+            if frame["ack"] is None and not level["data"] and before["data"]:
+                frame["ack"] = time
+            if reads:
+                bit = level["prb_read"] & 0x01
+                if bit and frame["release_seen"] is None:
+                    frame["release_seen"] = time
+                if not bit and frame["ack"] is not None and frame["ack_seen"] is None:
+                    frame["ack_seen"] = time
+
+        if not level["clock_out"]:
+            frames.append(frame)
+            frame = None
+
+    if frame is not None:
+        frames.append(frame)
+    return frames
+
+
+def describe(value):
+    command = COMMANDS.get(value & 0xF0)
+    return command.format(value & 0x0F) if command else "unknown"
+
+
+def spread(values):
+    return max(values) - min(values) if values else 0.0
+
+
+def check(frame, spec):
+    problems = []
+    if len(frame["bits"]) != 8:
+        problems.append(f"{len(frame['bits'])} bits")
+    if frame["setup"] and min(frame["setup"]) < spec["min_setup_us"]:
+        problems.append("setup")
+    if frame["hold"] and min(frame["hold"]) < spec["min_hold_us"]:
+        problems.append("hold")
+    halves = frame["low"] + frame["high"]
+    if halves and min(halves) < spec["min_half_period_us"]:
+        problems.append("short half period")
+    if halves and max(halves) > spec["max_half_period_us"]:
+        problems.append("long half period")
+    if max(spread(frame["low"]), spread(frame["high"])) > spec["max_jitter_us"]:
+        problems.append("jitter")
+    if frame["release"] is not None:
+        wait = frame["release_seen"]
+        if wait is None or wait - frame["release"] > spec["max_release_wait_us"]:
+            problems.append("release wait")
+        ack = frame["ack"]
+        if ack is not None and ack - frame["release"] > spec["max_ack_latency_us"]:
+            problems.append("ack latency")
+    return problems
+
+
+def summarize(frame, spec):
+    value = 0
+    for bit in frame["bits"]:
+        value = (value << 1) | bit
+    release = frame["release"]
+
+    def since(time, origin):
+        return None if time is None or origin is None else round(time - origin, 1)
+
+    return {
+        "time_ms": round(frame["start"] / 1000, 3),
+        "byte": value,
+        "command": describe(value) if len(frame["bits"]) == 8 else "incomplete",
+        "setup_us": round(min(frame["setup"]), 1) if frame["setup"] else None,
+        "hold_us": round(min(frame["hold"]), 1) if frame["hold"] else None,
+        "low_us": [round(min(frame["low"]), 1), round(max(frame["low"]), 1)]
+        if frame["low"] else None,
+        "high_us": [round(min(frame["high"]), 1), round(max(frame["high"]), 1)]
+        if frame["high"] else None,
+        "jitter_us": round(max(spread(frame["low"]), spread(frame["high"])), 1),
+        "release_wait_us": since(frame["release_seen"], release),
+        "ack_latency_us": since(frame["ack"], release),
+        "ack_detect_us": since(frame["ack_seen"], frame["ack"]),
+        "acknowledged": frame["ack_seen"] is not None,
+        "violations": check(frame, spec),
+    }
+
+
+def show(value):
+    if value is None:
+        return "-"
+    if isinstance(value, list):
+        return f"{value[0]:.0f}/{value[1]:.0f}"
+    return f"{value:.0f}"
+
+
+def main():
+    args = parse_args()
+
+    try:
+        spec = json.loads(args.spec.read_text())
+        missing = [key for key in SPEC_KEYS if key not in spec]
+        if missing:
+            raise ValueError(f"{args.spec} lacks {', '.join(missing)}")
+        scale, changes = read_vcd(args.trace)
+    except (json.JSONDecodeError, ValueError, KeyError, OSError) as error:
+        print(f"analyze_link: {error}", file=sys.stderr)
+        return 1
+
+    frames = [summarize(frame, spec) for frame in decode(changes, scale)]
+    print(f"{len(frames)} commands in {args.trace}; spec {spec.get('receiver', args.spec)}")
+    print("    time ms  byte  command        setup  hold   low us    high us  "
+          "jitter release    ack")
+    for frame in frames:
+        status = ", ".join(frame["violations"]) or (
+            "ok" if frame["acknowledged"] else "no ack")
+        print(f"{frame['time_ms']:11.3f}  ${frame['byte']:02X}  {frame['command']:<13}"
+              f"{show(frame['setup_us']):>6}{show(frame['hold_us']):>6}"
+              f"{show(frame['low_us']):>9}{show(frame['high_us']):>11}"
+              f"{show(frame['jitter_us']):>8}{show(frame['release_wait_us']):>8}"
+              f"{show(frame['ack_latency_us']):>7}  {status}")
+
+    if args.json:
+        args.json.write_text(json.dumps({"spec": spec, "frames": frames}, indent=2) + "\n")
+
+    failed = [frame for frame in frames if frame["violations"]]
+    if failed:
+        print(f"analyze_link: {len(failed)} of {len(frames)} commands outside the spec",
+              file=sys.stderr)
+        return 1
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,362 @@
+#!/usr/bin/env python3
+"""Local build service for online menu ROMs with a content-addressed cache.
+
+Accepts the same inputs as the "Build online menu ROM" workflow
+(request_id, bank_count, names_json) as JSON objects, either one per line
+over a Unix socket or as *.json files dropped into a spool directory.
+Requests run in a worker pool. Each result is cached under a hash of the
+normalised configuration and the firmware sources, so repeating a
+configuration returns the stored ultra36_32.bin and .sha256 at once.
+"""
+
+import argparse
+import hashlib
+import json
+import os
+import shutil
+import socketserver
+import subprocess
+import sys
+import tempfile
+import threading
+import time
+from concurrent.futures import ThreadPoolExecutor
+from pathlib import Path
+
+from generate_online_config import BANK_COUNTS, render_header, validate_names
+from rom_patch import NoNameTable, table_offset, write_names
+
+
+REPO = Path(__file__).resolve().parent.parent
+TEMPLATE = REPO / "templates" / "ultra36_32.bin"
+ROM_NAME = "ultra36_32.bin"
+SPOOL_POLL_SECONDS = 0.2
+
+# Everything that changes the produced ROM; generated headers and build
+# outputs are excluded, only the committed template is hashed
+SOURCE_GLOBS = (
+    "Makefile",
+    "src/*.c",
+    "src/*.h",
+    "src/*.s",
+    "src/ui_strings.txt",
+    "cart128_32/*",
+    "scripts/compress_strings.py",
+    "scripts/generate_online_config.py",
+    "scripts/rom_patch.py",
+    "templates/ultra36_32.bin",
+)
+GENERATED_HEADERS = (
+    "online_rom_config.h",
+    "rom_catalog_data.h",
+    "ui_string_ids.h",
+    "ui_string_data.h",
+)
+
+
+def parse_args():
+    parser = argparse.ArgumentParser()
+    parser.add_argument("--socket", type=Path, help="Unix socket to listen on")
+    parser.add_argument("--spool", type=Path, help="spool directory to watch")
+    parser.add_argument(
+        "--cache", type=Path, default=REPO / "build" / "cache", help="ROM cache"
+    )
+    parser.add_argument("--workers", type=int, default=os.cpu_count() or 2)
+    parser.add_argument(
+        "--compare",
+        choices=BANK_COUNTS,
+        metavar="BANK_COUNT",
+        help="time one ROM built by patching and one built from source, then exit",
+    )
+    args = parser.parse_args()
+    if args.socket is None and args.spool is None and args.compare is None:
+        parser.error("give --socket, --spool or both")
+    return args
+
+
+def source_files():
+    for pattern in SOURCE_GLOBS:
+        for path in sorted(REPO.glob(pattern)):
+            if path.is_file() and path.name not in GENERATED_HEADERS:
+                yield path
+
+
+def source_hash():
+    digest = hashlib.sha256()
+    for path in source_files():
+        digest.update(str(path.relative_to(REPO)).encode())
+        digest.update(b"\0")
+        digest.update(path.read_bytes())
+    return digest.hexdigest()
+
+
+def normalise(request):
+    """Validate a request and return (request_id, bank_count, names)."""
+    if not isinstance(request, dict):
+        raise ValueError("request must be a JSON object")
+
+    request_id = str(request.get("request_id", "manual"))
+    bank_count = str(request.get("bank_count", ""))
+    if bank_count not in BANK_COUNTS:
+        raise ValueError(f"bank_count must be one of {', '.join(BANK_COUNTS)}")
+
+    raw_names = request.get("names_json")
+    if isinstance(raw_names, str):
+        raw_names = json.loads(raw_names)
+    names = validate_names(raw_names, int(bank_count))
+
+    return request_id, int(bank_count), names
+
+
+def cache_key(bank_count, names, sources):
+    config = json.dumps(
+        {"bank_count": bank_count, "names": names},
+        sort_keys=True,
+        separators=(",", ":"),
+    )
+    return hashlib.sha256(f"{sources}\n{config}".encode()).hexdigest()
+
+
+def build_by_patch(names, output):
+    """Sub-millisecond path: patch the sealed template's name table."""
+    if not TEMPLATE.is_file():
+        raise NoNameTable(f"no template at {TEMPLATE}")
+    image = bytearray(TEMPLATE.read_bytes())
+    write_names(image, table_offset(image), names)
+    output.write_bytes(image)
+
+
+def build_from_source(bank_count, names, output, work_root):
+    """Full generate-and-build pipeline in an isolated copy of the tree."""
+    work = Path(tempfile.mkdtemp(prefix="build-", dir=work_root))
+    try:
+        for directory in ("src", "cart128_32", "scripts"):
+            shutil.copytree(REPO / directory, work / directory)
+        shutil.copy2(REPO / "Makefile", work / "Makefile")
+        (work / "build").mkdir()
+        for name in GENERATED_HEADERS:
+            (work / "src" / name).unlink(missing_ok=True)
+        (work / "src" / "online_rom_config.h").write_text(
+            render_header(names), encoding="ascii"
+        )
+
+        completed = subprocess.run(
+            # Built like the template, so 32 and 64 bank names work
+            ["make", "DEFS=-DONLINE_BUILD", "LINK_LATCHES=1"],
+            cwd=work,
+            capture_output=True,
+            text=True,
+            check=False,
+        )
+        if completed.returncode != 0:
+            raise RuntimeError(f"build failed:\n{completed.stdout}{completed.stderr}")
+        shutil.copy2(work / "build" / ROM_NAME, output)
+    finally:
+        shutil.rmtree(work, ignore_errors=True)
+
+
+class BuildService:
+    def __init__(self, cache, workers):
+        self.cache = cache
+        self.work_root = cache / "work"
+        self.work_root.mkdir(parents=True, exist_ok=True)
+        self.pool = ThreadPoolExecutor(max_workers=workers)
+        self.lock = threading.Lock()
+        self.in_flight = {}
+
+    def entry(self, key):
+        return self.cache / key[:2] / key
+
+    def handle(self, request):
+        """Serve one request dict; always returns a response dict."""
+        start = time.perf_counter()
+        request_id = str(request.get("request_id", "manual")) if isinstance(
+            request, dict
+        ) else "manual"
+
+        try:
+            request_id, bank_count, names = normalise(request)
+            key = cache_key(bank_count, names, source_hash())
+            entry = self.entry(key)
+            cached = (entry / ROM_NAME).exists()
+            if not cached:
+                self.produce(key, bank_count, names).result()
+            built = json.loads((entry / "config.json").read_text())
+        except (json.JSONDecodeError, ValueError, RuntimeError, OSError) as error:
+            return {"request_id": request_id, "status": "error", "error": str(error)}
+
+        return {
+            "request_id": request_id,
+            "status": "ok",
+            "cached": cached,
+            "key": key,
+            "rom": str(entry / ROM_NAME),
+            "sha256": (entry / f"{ROM_NAME}.sha256").read_text().split()[0],
+            "method": built.get("method"),
+            "build_ms": built.get("build_ms"),
+            "elapsed_ms": round((time.perf_counter() - start) * 1000, 3),
+        }
+
+    def produce(self, key, bank_count, names):
+        """Start (or join) the build for a cache key."""
+        with self.lock:
+            future = self.in_flight.get(key)
+            if future is None:
+                future = self.pool.submit(self.build, key, bank_count, names)
+                self.in_flight[key] = future
+                future.add_done_callback(lambda _: self.forget(key))
+            return future
+
+    def forget(self, key):
+        with self.lock:
+            self.in_flight.pop(key, None)
+
+    def build(self, key, bank_count, names):
+        entry = self.entry(key)
+        staging = Path(tempfile.mkdtemp(prefix="entry-", dir=self.work_root))
+        rom = staging / ROM_NAME
+
+        try:
+            start = time.perf_counter()
+            try:
+                build_by_patch(names, rom)
+                method = "patch"
+            except NoNameTable:
+                # Missing or stale template: compile instead
+                build_from_source(bank_count, names, rom, self.work_root)
+                method = "source"
+            build_ms = round((time.perf_counter() - start) * 1000, 3)
+
+            data = rom.read_bytes()
+            if len(data) != 0x8000:
+                raise RuntimeError(f"{ROM_NAME} is {len(data)} bytes, not 32KB")
+            digest = hashlib.sha256(data).hexdigest()
+            (staging / f"{ROM_NAME}.sha256").write_text(f"{digest}  {ROM_NAME}\n")
+            (staging / "config.json").write_text(
+                json.dumps(
+                    {
+                        "bank_count": bank_count,
+                        "names": names,
+                        "method": method,
+                        "build_ms": build_ms,
+                    },
+                    indent=2,
+                )
+                + "\n"
+            )
+
+            # Publish atomically so readers never see a half-written entry
+            entry.parent.mkdir(parents=True, exist_ok=True)
+            try:
+                staging.rename(entry)
+            except OSError:
+                if not (entry / ROM_NAME).exists():
+                    raise
+        finally:
+            shutil.rmtree(staging, ignore_errors=True)
+
+
+class SocketHandler(socketserver.StreamRequestHandler):
+    def handle(self):
+        for line in self.rfile:
+            if not line.strip():
+                continue
+            try:
+                request = json.loads(line)
+            except json.JSONDecodeError as error:
+                request = None
+                response = {"status": "error", "error": f"bad JSON: {error}"}
+            if request is not None:
+                response = self.server.service.handle(request)
+            self.wfile.write((json.dumps(response) + "\n").encode())
+            self.wfile.flush()
+
+
+class SocketServer(socketserver.ThreadingMixIn, socketserver.UnixStreamServer):
+    daemon_threads = True
+
+
+def serve_socket(service, path):
+    path.unlink(missing_ok=True)
+    server = SocketServer(str(path), SocketHandler)
+    server.service = service
+    print(f"Listening on {path}")
+    server.serve_forever()
+
+
+def serve_spool(service, spool):
+    """incoming/*.json -> processing/ -> done/<name>.json"""
+    incoming = spool / "incoming"
+    processing = spool / "processing"
+    done = spool / "done"
+    for directory in (incoming, processing, done):
+        directory.mkdir(parents=True, exist_ok=True)
+
+    def run(claimed):
+        try:
+            request = json.loads(claimed.read_text())
+        except (json.JSONDecodeError, OSError) as error:
+            response = {"status": "error", "error": f"bad request file: {error}"}
+        else:
+            response = service.handle(request)
+        result = done / claimed.name
+        result.with_suffix(".tmp").write_text(json.dumps(response, indent=2) + "\n")
+        result.with_suffix(".tmp").rename(result)
+        claimed.unlink(missing_ok=True)
+
+    print(f"Watching {incoming}")
+    while True:
+        for request_file in sorted(incoming.glob("*.json")):
+            claimed = processing / request_file.name
+            try:
+                request_file.rename(claimed)
+            except OSError:
+                continue
+            threading.Thread(target=run, args=(claimed,), daemon=True).start()
+        time.sleep(SPOOL_POLL_SECONDS)
+
+
+def compare(bank_count, work_root):
+    """Build one set of names both ways and print the time of each."""
+    names = validate_names([f"Bank_{n}" for n in range(bank_count - 2)], bank_count)
+    work_root.mkdir(parents=True, exist_ok=True)
+    output = Path(tempfile.mkdtemp(prefix="compare-", dir=work_root))
+    try:
+        for method, build in (
+            ("patch", lambda rom: build_by_patch(names, rom)),
+            ("source", lambda rom: build_from_source(bank_count, names, rom, work_root)),
+        ):
+            start = time.perf_counter()
+            try:
+                build(output / f"{method}.bin")
+            except (ValueError, RuntimeError, OSError) as error:
+                print(f"build_service: {method} build failed: {error}", file=sys.stderr)
+                return 1
+            print(f"{method:6} {(time.perf_counter() - start) * 1000:12.3f} ms")
+    finally:
+        shutil.rmtree(output, ignore_errors=True)
+    return 0
+
+
+def main():
+    args = parse_args()
+    if args.compare is not None:
+        return compare(int(args.compare), args.cache / "work")
+    service = BuildService(args.cache, max(1, args.workers))
+
+    if args.socket is not None and args.spool is not None:
+        threading.Thread(
+            target=serve_spool, args=(service, args.spool), daemon=True
+        ).start()
+    try:
+        if args.socket is not None:
+            serve_socket(service, args.socket)
+        else:
+            serve_spool(service, args.spool)
+    except KeyboardInterrupt:
+        return 0
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,217 @@
+#!/usr/bin/env python3
+"""Compress the menu's UI strings with a shared token dictionary.
+
+Reads src/ui_strings.txt (one 'NAME "text"' per line) and writes two
+headers: the UI_* string numbers and the packed data that src/ui_strings.c
+expands at run time. Strings are converted to PETSCII first. Substrings that
+pay off across all strings become tokens $80-$BF, which never occur in the
+PETSCII of the allowed characters; a token expands to plain characters only,
+so the decoder needs one table lookup per token.
+"""
+
+import argparse
+import re
+import sys
+from pathlib import Path
+
+from rom_patch import to_petscii
+
+
+TOKEN_FIRST = 0x80
+MAX_TOKENS = 64
+MAX_TOKEN_LENGTH = 12
+LINE = re.compile(r'^([A-Z][A-Z0-9_]*)\s+"(.*)"$')
+
+
+def parse_args():
+    parser = argparse.ArgumentParser()
+    parser.add_argument("source", type=Path)
+    parser.add_argument("--ids", required=True, type=Path)
+    parser.add_argument("--data", required=True, type=Path)
+    parser.add_argument("--omit", action="append", default=[], metavar="PREFIX",
+                        help="leave out the strings of a page not built in, e.g. SID_")
+    return parser.parse_args()
+
+
+def read_strings(path, omit=()):
+    strings = []
+    seen = set()
+
+    for number, line in enumerate(path.read_text().splitlines(), 1):
+        line = line.strip()
+        if not line or line.startswith("#"):
+            continue
+        match = LINE.match(line)
+        if match is None:
+            raise ValueError(f"{path}:{number}: expected NAME \"text\"")
+        name, text = match.groups()
+        if name in seen:
+            raise ValueError(f"{path}:{number}: {name} is defined twice")
+        encoded = to_petscii(text)
+        if any(byte < 0x20 or TOKEN_FIRST <= byte < TOKEN_FIRST + MAX_TOKENS
+               for byte in encoded):
+            raise ValueError(f"{path}:{number}: unsupported character in {name}")
+        seen.add(name)
+        if not name.startswith(tuple(omit)):
+            strings.append((name, encoded))
+
+    if len(strings) > 256:
+        raise ValueError("more than 256 UI strings")
+    return strings
+
+
+def literal_runs(sequence):
+    """Yield (start, run) for each stretch of plain characters."""
+    start = 0
+    for index, symbol in enumerate(sequence + [None]):
+        if symbol is None or symbol >= 0x100:
+            if index > start:
+                yield start, sequence[start:index]
+            start = index + 1
+
+
+def best_token(sequences):
+    counts = {}
+
+    for sequence in sequences:
+        for _, run in literal_runs(sequence):
+            for length in range(2, min(MAX_TOKEN_LENGTH, len(run)) + 1):
+                for start in range(len(run) - length + 1):
+                    key = tuple(run[start:start + length])
+                    counts[key] = counts.get(key, 0) + 1
+
+    best, best_saving = None, 0
+    for key, count in counts.items():
+        # Each use saves len-1 bytes; the dictionary entry costs len + 2
+        saving = count * (len(key) - 1) - (len(key) + 2)
+        if saving > best_saving:
+            best, best_saving = key, saving
+    return best
+
+
+def replace(sequence, key, symbol):
+    result = []
+    index = 0
+    length = len(key)
+
+    while index < len(sequence):
+        if tuple(sequence[index:index + length]) == key:
+            result.append(symbol)
+            index += length
+        else:
+            result.append(sequence[index])
+            index += 1
+    return result
+
+
+def compress(strings):
+    # Tokens are symbols >= $100 while building, renumbered at the end
+    sequences = [list(encoded) for _, encoded in strings]
+    tokens = []
+
+    while len(tokens) < MAX_TOKENS:
+        key = best_token(sequences)
+        if key is None:
+            break
+        symbol = 0x100 + len(tokens)
+        sequences = [replace(sequence, key, symbol) for sequence in sequences]
+        tokens.append(bytes(key))
+
+    texts = [bytes(TOKEN_FIRST + symbol - 0x100 if symbol >= 0x100 else symbol
+                   for symbol in sequence)
+             for sequence in sequences]
+    return tokens, texts
+
+
+def c_bytes(data, indent="    "):
+    lines = []
+    for start in range(0, len(data), 12):
+        chunk = data[start:start + 12]
+        lines.append(indent + ", ".join(f"0x{byte:02X}" for byte in chunk) + ",")
+    return "\n".join(lines)
+
+
+def c_words(values, indent="    "):
+    lines = []
+    for start in range(0, len(values), 8):
+        chunk = values[start:start + 8]
+        lines.append(indent + ", ".join(str(value) for value in chunk) + ",")
+    return "\n".join(lines)
+
+
+def write_ids(path, strings):
+    longest = max(len(encoded) for _, encoded in strings)
+    width = max(len(name) for name, _ in strings) + 3
+    lines = [
+        "// Generated by scripts/compress_strings.py from src/ui_strings.txt",
+        "#ifndef UI_STRING_IDS_H",
+        "#define UI_STRING_IDS_H",
+        "",
+        f"#define {'UI_STRING_COUNT':<{width}} {len(strings)}",
+        f"#define {'UI_TEXT_MAX':<{width}} {longest}",
+        "",
+    ]
+    for number, (name, _) in enumerate(strings):
+        lines.append(f"#define {'UI_' + name:<{width}} {number}")
+    lines += ["", "#endif", ""]
+    path.write_text("\n".join(lines))
+
+
+def write_data(path, tokens, texts):
+    token_offsets = [0]
+    for token in tokens:
+        token_offsets.append(token_offsets[-1] + len(token))
+    text_offsets = []
+    packed = bytearray()
+    for text in texts:
+        text_offsets.append(len(packed))
+        packed += text + b"\0"
+
+    lines = [
+        "// Generated by scripts/compress_strings.py from src/ui_strings.txt",
+        f"#define UI_TOKEN_FIRST 0x{TOKEN_FIRST:02X}",
+        f"#define UI_TOKEN_COUNT {len(tokens)}",
+        "",
+        "static const unsigned int ui_token_offset[UI_TOKEN_COUNT + 1] = {",
+        c_words(token_offsets),
+        "};",
+        "",
+        "static const unsigned char ui_tokens[] = {",
+        c_bytes(b"".join(tokens) or b"\0"),
+        "};",
+        "",
+        "static const unsigned int ui_text_offset[UI_STRING_COUNT] = {",
+        c_words(text_offsets),
+        "};",
+        "",
+        "static const unsigned char ui_texts[] = {",
+        c_bytes(bytes(packed)),
+        "};",
+        "",
+    ]
+    path.write_text("\n".join(lines))
+    return token_offsets[-1] + 2 * len(token_offsets) + len(packed) + 2 * len(texts)
+
+
+def main():
+    args = parse_args()
+
+    try:
+        strings = read_strings(args.source, args.omit)
+        if not strings:
+            raise ValueError(f"{args.source} has no strings")
+        tokens, texts = compress(strings)
+        write_ids(args.ids, strings)
+        packed = write_data(args.data, tokens, texts)
+    except (OSError, ValueError) as error:
+        print(f"compress_strings: {error}", file=sys.stderr)
+        return 1
+
+    plain = sum(len(encoded) + 3 for _, encoded in strings)
+    print(f"UI strings: {len(strings)} strings, {len(tokens)} tokens, "
+          f"{plain} -> {packed} bytes")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
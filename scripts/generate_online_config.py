@@ -7,11 +7,13 @@ from pathlib import Path
 
 
 MAX_NAME_LENGTH = 16
+# 32K flash windows: SST39SF020A, SST39SF040 and 1MB/2MB parts
+BANK_COUNTS = ("8", "16", "32", "64")
 
 
 def parse_args():
     parser = argparse.ArgumentParser()
-    parser.add_argument("--bank-count", required=True, choices=("8", "16"))
+    parser.add_argument("--bank-count", required=True, choices=BANK_COUNTS)
     parser.add_argument("--names-json", required=True)
     parser.add_argument("--output", required=True, type=Path)
     return parser.parse_args()
@@ -0,0 +1,141 @@
+#!/usr/bin/env python3
+"""Set the "max" limits of a harness UI script from measured latencies."""
+
+import argparse
+import json
+import math
+import re
+import sys
+from pathlib import Path
+
+
+LIMIT_PATTERN = re.compile(r"^\s+max\s+\d+")
+
+
+def parse_args():
+    parser = argparse.ArgumentParser()
+    parser.add_argument("script", type=Path, help="harness script to update")
+    parser.add_argument(
+        "reports",
+        type=Path,
+        nargs="*",
+        help="ultra36-harness -j reports; the slowest one sets each limit",
+    )
+    parser.add_argument(
+        "--margin",
+        type=int,
+        default=25,
+        help="headroom over the measured frames in percent (default 25)",
+    )
+    parser.add_argument(
+        "--strip",
+        type=Path,
+        help="only write a copy of the script without limits to this path",
+    )
+    parser.add_argument(
+        "--check",
+        action="store_true",
+        help="only check that every timed line of the script has a limit",
+    )
+    return parser.parse_args()
+
+
+def is_timed(line):
+    return line.split(" ", 1)[0] in ("idle", "key")
+
+
+def has_limit(line):
+    command, _, rest = line.partition(" ")
+    if command == "key":
+        rest = rest.partition(" ")[2]
+    return LIMIT_PATTERN.match(" " + rest) is not None
+
+
+def strip_limit(line):
+    command, _, rest = line.partition(" ")
+    if command == "key":
+        keys, _, rest = rest.partition(" ")
+        return f"{command} {keys}" + LIMIT_PATTERN.sub("", " " + rest, count=1).rstrip()
+    return command + LIMIT_PATTERN.sub("", " " + rest, count=1).rstrip()
+
+
+def with_limit(line, frames):
+    command, _, rest = strip_limit(line).partition(" ")
+    if command == "key":
+        keys, _, label = rest.partition(" ")
+        return f"{command} {keys} max {frames} {label}".rstrip()
+    return f"{command} max {frames} {rest}".rstrip()
+
+
+def slowest(reports):
+    frames = None
+
+    for path in reports:
+        interactions = json.loads(path.read_text())["interactions"]
+        for entry in interactions:
+            if entry["timeout"]:
+                raise ValueError(f"{path}: \"{entry['label']}\" timed out")
+        measured = [entry["frames"] for entry in interactions]
+        if frames is None:
+            frames = measured
+        elif len(measured) != len(frames):
+            raise ValueError(f"{path}: {len(measured)} interactions, expected {len(frames)}")
+        else:
+            frames = [max(a, b) for a, b in zip(frames, measured)]
+
+    return frames or []
+
+
+def main():
+    args = parse_args()
+    lines = args.script.read_text().splitlines()
+
+    if args.strip is not None:
+        args.strip.write_text(
+            "\n".join(strip_limit(line) if is_timed(line) else line for line in lines)
+            + "\n"
+        )
+        return 0
+
+    if args.check:
+        missing = [
+            number
+            for number, line in enumerate(lines, 1)
+            if is_timed(line) and not has_limit(line)
+        ]
+        for number in missing:
+            print(f"{args.script}:{number}: no max limit", file=sys.stderr)
+        if missing:
+            print(
+                "latency_limits: run 'make latency-limits' and commit the script",
+                file=sys.stderr,
+            )
+            return 1
+        return 0
+
+    try:
+        frames = slowest(args.reports)
+    except (OSError, ValueError, KeyError) as error:
+        print(f"latency_limits: {error}", file=sys.stderr)
+        return 1
+
+    timed = [index for index, line in enumerate(lines) if is_timed(line)]
+    if len(timed) != len(frames):
+        print(
+            f"latency_limits: {args.script} has {len(timed)} timed lines, "
+            f"the reports {len(frames)} interactions",
+            file=sys.stderr,
+        )
+        return 1
+
+    for index, measured in zip(timed, frames):
+        limit = max(math.ceil(measured * (100 + args.margin) / 100), math.ceil(measured) + 2)
+        lines[index] = with_limit(lines[index], limit)
+        print(f"{measured:8.2f} frames -> max {limit:4}  {lines[index]}")
+
+    args.script.write_text("\n".join(lines) + "\n")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
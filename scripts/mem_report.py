@@ -0,0 +1,274 @@
+#!/usr/bin/env python3
+"""Report memory area and segment usage of a linked menu ROM from its ld65 map.
+
+Each ROM area also gets a headroom figure: the bytes between the segments
+ld65 places itself and the next segment at a fixed address (or the end of
+the area), which is what the code can still grow into. --summary collects
+those figures from several reports, e.g. one per build profile. With
+--stack-used (the C stack high-water mark of a hardware run) it also gives
+the RAM and C stack reservations that fit the build plus --margin bytes.
+"""
+
+import argparse
+import re
+import sys
+from pathlib import Path
+
+
+BLOCK_PATTERN = r"^{}\s*\{{(.*?)^\}}"
+ENTRY_PATTERN = re.compile(r"^\s*(\w+)\s*:\s*([^;]*);", re.MULTILINE)
+ATTRIBUTE_PATTERN = re.compile(r"(\w+)\s*=\s*([^,]+)")
+SEGMENT_LINE = re.compile(
+    r"^(\w+)\s+([0-9A-F]{6})\s+([0-9A-F]{6})\s+([0-9A-F]{6})\s+([0-9A-F]{5})$"
+)
+
+# Library modules that only get linked when something allocates
+HEAP_MODULES = re.compile(r"\((_heap|_heapadd|malloc|calloc|realloc|free)\.o\)")
+
+HEADROOM_LINE = re.compile(r"^Headroom (\w+): (\d+) bytes")
+
+# The C stack is painted and scanned a page at a time (stack_usage.s)
+PAGE = 256
+
+
+def parse_args():
+    parser = argparse.ArgumentParser()
+    parser.add_argument("--config", type=Path)
+    parser.add_argument("--map", type=Path)
+    parser.add_argument("--output", type=Path, help="also write the report here")
+    parser.add_argument("--min-free", type=int, default=0,
+                        help="fail when a ROM area has less headroom than this")
+    parser.add_argument("--summary", nargs="+", type=Path, metavar="REPORT",
+                        help="tabulate the headroom of existing reports instead")
+    parser.add_argument("--define", nargs="*", default=[], metavar="SYMBOL=VALUE",
+                        help="linker config symbols overridden with ld65 -D")
+    parser.add_argument("--stack-used", type=int,
+                        help="measured C stack bytes; report the reservations that fit")
+    parser.add_argument("--margin", type=int, default=PAGE,
+                        help="bytes added to the measured RAM and stack use")
+    args = parser.parse_args()
+    if not args.summary and not (args.config and args.map):
+        parser.error("--config and --map are required without --summary")
+    return args
+
+
+def config_block(text, name):
+    match = re.search(BLOCK_PATTERN.format(name), text, re.MULTILINE | re.DOTALL)
+    if match is None:
+        raise ValueError(f"no {name} block in the linker config")
+    body = re.sub(r"#.*", "", match.group(1))
+    return {
+        entry: dict(ATTRIBUTE_PATTERN.findall(attributes))
+        for entry, attributes in ENTRY_PATTERN.findall(body)
+    }
+
+
+def evaluate(expression, symbols):
+    # Config values are sums and differences of $hex numbers and symbols
+    total = 0
+    for sign, term in re.findall(r"([+-]?)\s*(\$?\w+)", expression):
+        if term.startswith("$"):
+            value = int(term[1:], 16)
+        elif term in symbols:
+            value = symbols[term]
+        else:
+            value = int(term, 0)
+        total += -value if sign == "-" else value
+    return total
+
+
+def read_config(path, defines):
+    text = path.read_text()
+    symbols = {
+        name: evaluate(attributes["value"], {})
+        for name, attributes in config_block(text, "SYMBOLS").items()
+    }
+    for define in defines:
+        name, _, value = define.partition("=")
+        if name not in symbols:
+            raise ValueError(f"{name} is not a symbol of {path}")
+        symbols[name] = evaluate(value, {})
+    areas = {
+        name: (
+            evaluate(attributes["start"], symbols),
+            evaluate(attributes["size"], symbols),
+        )
+        for name, attributes in config_block(text, "MEMORY").items()
+    }
+    # Areas written to the output file are the ROM
+    rom_areas = [
+        name for name, attributes in config_block(text, "MEMORY").items()
+        if "file" in attributes
+    ]
+    segments = config_block(text, "SEGMENTS")
+    placement = {
+        name: (attributes["load"].strip(), attributes.get("run", attributes["load"]).strip())
+        for name, attributes in segments.items()
+    }
+    fixed = {
+        name: evaluate(attributes["start"], symbols)
+        for name, attributes in segments.items()
+        if "start" in attributes
+    }
+    return areas, rom_areas, placement, fixed
+
+
+def read_map(path):
+    text = path.read_text()
+    segments = {}
+    in_list = False
+    for line in text.splitlines():
+        if line.startswith("Segment list:"):
+            in_list = True
+        elif in_list and line.startswith("Exports list"):
+            break
+        elif in_list:
+            match = SEGMENT_LINE.match(line.strip())
+            if match:
+                segments[match.group(1)] = (int(match.group(2), 16), int(match.group(4), 16))
+    if not segments:
+        raise ValueError(f"{path} has no ld65 segment list")
+    return segments, sorted(set(HEAP_MODULES.findall(text)))
+
+
+def headroom(area, areas, placement, fixed, segments):
+    """Free bytes after the last segment ld65 places itself in a ROM area,
+    or None for an area that only holds fixed segments (padding)."""
+    start, size = areas[area]
+    # The map gives run addresses, so lay the load image out again in
+    # config order; DATA is copied to RAM but occupies ROM here. Optional
+    # segments missing from the map count as empty.
+    layout = []
+    position = start
+    for name, (load, _) in placement.items():
+        if load != area:
+            continue
+        position = fixed.get(name, position)
+        segment_size = segments.get(name, (0, 0))[1]
+        layout.append((name, position, segment_size))
+        position += segment_size
+
+    floating = [entry for entry in layout if entry[0] not in fixed]
+    if not floating:
+        return None
+    _, address, segment_size = floating[-1]
+    end = address + segment_size
+    limits = [start + size] + [
+        address for name, address, _ in layout if name in fixed and address >= end
+    ]
+    return min(limits) - end
+
+
+def page_up(size):
+    return -(-size // PAGE) * PAGE
+
+
+def fit_reservations(areas, placement, segments, stack_used, margin):
+    """RAM_SIZE and STACK_SIZE for the Makefile: the bytes DATA and BSS
+    take in RAM and the measured stack use, each plus the margin, in whole
+    pages so the stack stays page aligned."""
+    ram_used = sum(
+        segments[name][1]
+        for name, (_, run) in placement.items()
+        if run == "RAM" and name in segments
+    )
+    ram_size = page_up(ram_used + margin)
+    stack_size = page_up(stack_used + margin)
+    start = areas["RAM"][0]
+    return [
+        f"Fit with {margin} bytes margin: RAM_SIZE={ram_size} STACK_SIZE={stack_size}",
+        f"  RAM ${start:04X}-${start + ram_size - 1:04X} ({ram_used} used),"
+        f" C stack ${start + ram_size:04X}-${start + ram_size + stack_size - 1:04X}"
+        f" ({stack_used} used)",
+    ]
+
+
+def build_report(config_path, map_path, min_free, defines=(), stack_used=None,
+                 margin=PAGE):
+    areas, rom_areas, placement, fixed = read_config(config_path, defines)
+    segments, heap_modules = read_map(map_path)
+
+    lines = [f"Memory budget of {map_path} ({config_path})", ""]
+    lines.append(f"{'Area':<10} {'Start':>6} {'Size':>6} {'Used':>6} {'Free':>6} {'Used%':>6}")
+    for area, (start, size) in areas.items():
+        members = [
+            (name, segments[name])
+            for name, (load, run) in placement.items()
+            if name in segments and area in (load, run)
+        ]
+        used = sum(segment_size for _, (_, segment_size) in members)
+        percent = used * 100 // size if size else 0
+        lines.append(
+            f"{area:<10} {'$%04X' % start:>6} {size:6} {used:6} {size - used:6} {percent:5}%"
+        )
+        for name, (segment_start, segment_size) in members:
+            if segment_size:
+                lines.append(f"  {name:<9} {'$%04X' % segment_start} {segment_size:13}")
+
+    lines.append("")
+    problems = []
+    for area in rom_areas:
+        free = headroom(area, areas, placement, fixed, segments)
+        if free is None:
+            continue
+        lines.append(f"Headroom {area}: {free} bytes")
+        if free < min_free:
+            problems.append(f"{area} has {free} bytes of headroom, under {min_free}")
+
+    lines.append("")
+    if stack_used is None:
+        lines.append("CSTACK use is measured at run time: CTRL-P in a PROFILE build.")
+    else:
+        lines.extend(fit_reservations(areas, placement, segments, stack_used, margin))
+    if heap_modules:
+        lines.append("Heap modules linked: " + ", ".join(m + ".o" for m in heap_modules))
+        problems.append("the menu must not allocate from the heap")
+    else:
+        lines.append("No heap modules linked.")
+    return "\n".join(lines) + "\n", problems
+
+
+def summarize(reports, min_free):
+    lines = [f"{'Build':<28} {'Area':<8} {'Headroom':>8}"]
+    problems = []
+    for report in reports:
+        # Reports of "make headroom" sit in one directory per build
+        label = report.parent.name if report.parent.name != "build" else report.stem
+        found = False
+        for line in report.read_text().splitlines():
+            match = HEADROOM_LINE.match(line)
+            if match is None:
+                continue
+            found = True
+            area, free = match.group(1), int(match.group(2))
+            lines.append(f"{label:<28} {area:<8} {free:8}")
+            if free < min_free:
+                problems.append(f"{label} {area} has {free} bytes of headroom, under {min_free}")
+        if not found:
+            raise ValueError(f"{report} has no headroom lines")
+    return "\n".join(lines) + "\n", problems
+
+
+def main():
+    args = parse_args()
+
+    try:
+        if args.summary:
+            report, problems = summarize(args.summary, args.min_free)
+        else:
+            report, problems = build_report(args.config, args.map, args.min_free,
+                                            args.define, args.stack_used, args.margin)
+        if args.output:
+            args.output.write_text(report)
+    except (ValueError, KeyError, OSError) as error:
+        print(f"mem_report: {error}", file=sys.stderr)
+        return 1
+
+    sys.stdout.write(report)
+    for problem in problems:
+        print(f"mem_report: {problem}", file=sys.stderr)
+    return 1 if problems else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
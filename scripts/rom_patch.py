@@ -0,0 +1,207 @@
+#!/usr/bin/env python3
+"""Patch the bank label table of a prebuilt Ultra36 menu ROM and seal its CRCs."""
+
+import argparse
+import binascii
+import json
+import struct
+import sys
+import time
+from pathlib import Path
+
+from generate_online_config import BANK_COUNTS, validate_names
+
+
+# Layout of struct name_table in src/name_table.h
+MAGIC = b"U36N"
+VERSION = 4
+MAX_NAMES = 62
+NAME_SIZE = 17
+INDEX_KEYS = 27
+HEADER = struct.Struct("<4sBBH")
+NAMES_SIZE = MAX_NAMES * NAME_SIZE
+INDEX_OFFSET = HEADER.size + NAMES_SIZE
+SLOTS_OFFSET = INDEX_OFFSET + MAX_NAMES + INDEX_KEYS + 1
+TABLE_SIZE = SLOTS_OFFSET + MAX_NAMES
+
+# The linker fixes the table at $C000 (32K build) or $BB00 (16K build)
+TABLE_OFFSETS = {0x8000: 0x4000, 0x4000: 0x3B00}
+
+# CRC-16/CCITT words checked by rom_self_check(): (start, end, position) of
+# each covered range. The 32K build has one per 16K half, the upper one
+# stopping short of the CRCs and the $FF00 MMU page; the 16K build has one.
+CRC_RANGES = {
+    0x8000: ((0x0000, 0x4000, 0x7EFC), (0x4000, 0x7EFC, 0x7EFE)),
+    0x4000: ((0x0000, 0x3FFE, 0x3FFE),),
+}
+
+# Exit status when the template has no usable name table (missing file, built
+# before the table existed or an older table version). The online build
+# falls back to a full cc65 build only then; invalid names still exit 1.
+NO_TABLE_STATUS = 3
+
+# cc65 maps C string literals to PETSCII; the patched names must match
+PETSCII_SPECIAL = {
+    "\\": 0xBF,
+    "_": 0xA4,
+    "`": 0xAD,
+    "{": 0xB3,
+    "|": 0xDD,
+    "}": 0xAB,
+    "~": 0xB1,
+}
+
+
+class NoNameTable(ValueError):
+    pass
+
+
+def parse_args():
+    parser = argparse.ArgumentParser()
+    commands = parser.add_subparsers(dest="command", required=True)
+
+    names = commands.add_parser("names", help="write new labels into a template")
+    names.add_argument("--bank-count", required=True, choices=BANK_COUNTS)
+    names.add_argument("--names-json", required=True)
+    names.add_argument("--template", required=True, type=Path)
+    names.add_argument("--output", required=True, type=Path)
+
+    seal = commands.add_parser("seal", help="recompute the table checksum and image CRCs")
+    seal.add_argument("image", type=Path)
+
+    return parser.parse_args()
+
+
+def to_petscii(name):
+    encoded = bytearray()
+
+    for character in name:
+        if "a" <= character <= "z":
+            encoded.append(ord(character) - 0x20)
+        elif "A" <= character <= "Z":
+            encoded.append(ord(character) + 0x80)
+        else:
+            encoded.append(PETSCII_SPECIAL.get(character, ord(character)))
+
+    return bytes(encoded)
+
+
+def table_offset(image):
+    offset = TABLE_OFFSETS.get(len(image))
+    if offset is None:
+        raise ValueError(f"{len(image)} bytes is not a 16K or 32K menu ROM")
+
+    magic, version, _, _ = HEADER.unpack_from(image, offset)
+    if magic != MAGIC:
+        raise NoNameTable("menu ROM has no name table; rebuild it with make")
+    if version != VERSION:
+        raise NoNameTable(f"name table version {version} is not supported")
+
+    return offset
+
+
+def fold(byte):
+    """Case-insensitive PETSCII letter, as fold() in src/name_table.c."""
+    return byte & 0x7F if 0x41 <= byte & 0x7F <= 0x5A else byte
+
+
+def index_key(byte):
+    byte = fold(byte)
+    return byte - 0x40 if 0x41 <= byte <= 0x5A else 0
+
+
+def write_index(image, offset):
+    """Sort the names by first-letter key, then by folded label."""
+    count = image[offset + 5]
+    names_offset = offset + HEADER.size
+    labels = []
+    for index in range(count):
+        start = names_offset + index * NAME_SIZE
+        label = bytes(image[start : start + NAME_SIZE - 1]).split(b"\0", 1)[0]
+        labels.append(label)
+
+    def sort_key(index):
+        label = labels[index]
+        folded = bytes(fold(byte) for byte in label)
+        return (index_key(label[0]) if label else 0, folded, index)
+
+    order = sorted(range(count), key=sort_key)
+    first = []
+    position = 0
+    for key in range(INDEX_KEYS + 1):
+        while position < count and index_key(labels[order[position]][0]) < key:
+            position += 1
+        first.append(position)
+
+    order_offset = offset + INDEX_OFFSET
+    image[order_offset : order_offset + MAX_NAMES] = bytes(order).ljust(
+        MAX_NAMES, b"\0"
+    )
+    image[order_offset + MAX_NAMES : offset + SLOTS_OFFSET] = bytes(first)
+
+
+def checksum(image, offset):
+    body = image[offset + HEADER.size : offset + TABLE_SIZE]
+    return (image[offset + 4] + image[offset + 5] + sum(body)) & 0xFFFF
+
+
+def seal(image, offset):
+    write_index(image, offset)
+    struct.pack_into("<H", image, offset + 6, checksum(image, offset))
+    seal_crc(image)
+
+
+def seal_crc(image):
+    # Runs last: the ranges cover the name table sealed above
+    for start, end, position in CRC_RANGES[len(image)]:
+        crc = binascii.crc_hqx(bytes(image[start:end]), 0xFFFF)
+        struct.pack_into("<H", image, position, crc)
+
+
+def write_names(image, offset, names):
+    image[offset + 5] = len(names)
+    names_offset = offset + HEADER.size
+    image[names_offset : names_offset + NAMES_SIZE] = bytes(NAMES_SIZE)
+    # Patched names use the unpacked layout: name n in bank n + 2
+    image[offset + SLOTS_OFFSET : offset + TABLE_SIZE] = bytes(MAX_NAMES)
+
+    for index, name in enumerate(names):
+        start = names_offset + index * NAME_SIZE
+        encoded = to_petscii(name)
+        image[start : start + len(encoded)] = encoded
+
+    seal(image, offset)
+
+
+def main():
+    args = parse_args()
+
+    try:
+        if args.command == "names":
+            raw_names = json.loads(args.names_json)
+            names = validate_names(raw_names, int(args.bank_count))
+            if not args.template.is_file():
+                raise NoNameTable(f"no template at {args.template}; run make template")
+            image = bytearray(args.template.read_bytes())
+            start = time.perf_counter()
+            write_names(image, table_offset(image), names)
+            elapsed = (time.perf_counter() - start) * 1000
+            args.output.parent.mkdir(parents=True, exist_ok=True)
+            args.output.write_bytes(image)
+            print(f"Patched {len(names)} user ROM names in {elapsed:.3f} ms")
+        else:
+            image = bytearray(args.image.read_bytes())
+            seal(image, table_offset(image))
+            args.image.write_bytes(image)
+    except NoNameTable as error:
+        print(f"rom_patch: {error}", file=sys.stderr)
+        return NO_TABLE_STATUS
+    except (json.JSONDecodeError, ValueError, OSError) as error:
+        print(f"rom_patch: {error}", file=sys.stderr)
+        return 1
+
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,151 @@
+#!/usr/bin/env python3
+"""Run the sim65 cycle benchmarks and compare them against a baseline."""
+
+import argparse
+import json
+import re
+import subprocess
+import sys
+from pathlib import Path
+
+
+ROUTINES = (
+    "fill_line",
+    "draw_option",
+    "draw_content_area",
+    "send_byte",
+    "vdc_verify_run",
+    "vdc_fill",
+    "vdc_block_fill",
+    "vdc_copy",
+    "vdc_block_copy",
+    "vdc_write_run",
+    "vdc_write_loop",
+    "play_sid_sound_check",
+)
+WIDTHS = (40, 80)
+
+CYCLES_PATTERN = re.compile(r"(\d+)\s+cycles")
+ITERATIONS_PATTERN = re.compile(r"iterations\s+(\d+)")
+
+
+def parse_args():
+    parser = argparse.ArgumentParser()
+    parser.add_argument("--sim65", default="sim65")
+    parser.add_argument("--binary", required=True, type=Path)
+    parser.add_argument("--output", required=True, type=Path)
+    parser.add_argument("--baseline", required=True, type=Path)
+    parser.add_argument(
+        "--tolerance",
+        type=float,
+        default=2.0,
+        help="allowed regression in percent before the run fails",
+    )
+    parser.add_argument(
+        "--update-baseline",
+        action="store_true",
+        help="store this run as the new baseline",
+    )
+    return parser.parse_args()
+
+
+def run_routine(sim65, binary, routine, width):
+    completed = subprocess.run(
+        [sim65, "-c", str(binary), routine, str(width)],
+        capture_output=True,
+        text=True,
+        check=False,
+    )
+    output = completed.stdout + completed.stderr
+    if completed.returncode != 0:
+        raise RuntimeError(f"{routine} at {width} columns failed:\n{output}")
+
+    cycles = CYCLES_PATTERN.search(output)
+    iterations = ITERATIONS_PATTERN.search(output)
+    if cycles is None or iterations is None:
+        raise RuntimeError(f"cannot parse sim65 output for {routine}:\n{output}")
+
+    return int(cycles.group(1)), int(iterations.group(1))
+
+
+def measure(sim65, binary):
+    results = {}
+
+    for width in WIDTHS:
+        overhead, _ = run_routine(sim65, binary, "null", width)
+        for routine in ROUTINES:
+            total, iterations = run_routine(sim65, binary, routine, width)
+            results[f"{routine}@{width}"] = (total - overhead) // iterations
+
+    return results
+
+
+def compare(results, baseline, tolerance):
+    regressions = []
+    missing = []
+
+    for key, cycles in results.items():
+        reference = baseline.get(key)
+        if reference is None:
+            print(f"{key:32} {cycles:>10}  (not in baseline)")
+            missing.append(key)
+            continue
+
+        change = (cycles - reference) * 100.0 / reference if reference else 0.0
+        print(f"{key:32} {cycles:>10}  {reference:>10}  {change:+7.2f}%")
+        if change > tolerance:
+            regressions.append(key)
+
+    return regressions, missing
+
+
+def main():
+    args = parse_args()
+
+    try:
+        results = measure(args.sim65, args.binary)
+    except (OSError, RuntimeError) as error:
+        print(f"bench: {error}", file=sys.stderr)
+        return 1
+
+    args.output.write_text(json.dumps(results, indent=2, sort_keys=True) + "\n")
+
+    if args.update_baseline:
+        args.baseline.write_text(
+            json.dumps(results, indent=2, sort_keys=True) + "\n"
+        )
+        print(f"Baseline written to {args.baseline}")
+        return 0
+
+    if not args.baseline.exists():
+        for key, cycles in results.items():
+            print(f"{key:32} {cycles:>10}")
+        print(
+            f"bench: no baseline at {args.baseline}; "
+            "record one with 'make bench-baseline'",
+            file=sys.stderr,
+        )
+        return 1
+
+    baseline = json.loads(args.baseline.read_text())
+    regressions, missing = compare(results, baseline, args.tolerance)
+    status = 0
+    if missing:
+        print(
+            f"Not in baseline: {', '.join(missing)}; "
+            "re-record with 'make bench-baseline'",
+            file=sys.stderr,
+        )
+        status = 1
+    if regressions:
+        print(
+            f"Regressed past {args.tolerance}%: {', '.join(regressions)}",
+            file=sys.stderr,
+        )
+        status = 1
+
+    return status
+
+
+if __name__ == "__main__":
+    sys.exit(main())
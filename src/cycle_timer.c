@@ -0,0 +1,53 @@
+//   _____  ___________              _______________
+//   __  / / /__  /_  /_____________ __|__  /_  ___/
+//   _  / / /__  /_  __/_  ___/  __ `/__/_ <_  __ \
+//   / /_/ / _  / / /_ _  /   / /_/ /____/ // /_/ /
+//   \____/  /_/  \__/ /_/    \__,_/ /____/ \____/
+// Ultra-36 Rom Switcher for Commodore 128 - C128 Menu Program - cycle_timer.c
+// Free for personal use.
+// Commercial use or resale (in whole or part) prohibited without permission.
+// (c) 2025 Lukasz Dziwosz / LukasSoft. All Rights Reserved.
+
+#include <peekpoke.h>
+#include "cycle_timer.h"
+
+#define CIA2_TA_LO          0xDD04
+#define CIA2_TA_HI          0xDD05
+#define CIA2_TB_LO          0xDD06
+#define CIA2_TB_HI          0xDD07
+#define CIA2_CRA            0xDD0E
+#define CIA2_CRB            0xDD0F
+
+void cycle_timer_run(void)
+{
+    if (PEEK(CIA2_CRA) & 0x01)
+        return;
+    POKE(CIA2_CRB, 0x00);
+    POKE(CIA2_TA_LO, 0xFF);
+    POKE(CIA2_TA_HI, 0xFF);
+    POKE(CIA2_TB_LO, 0xFF);
+    POKE(CIA2_TB_HI, 0xFF);
+    POKE(CIA2_CRB, 0x51);   // Load, count timer A underflows, start
+    POKE(CIA2_CRA, 0x11);   // Load, count system clock, start
+}
+
+unsigned long cycle_timer_read(void)
+{
+    unsigned char b_hi, b_lo, a_hi, a_lo;
+
+    // The counter keeps running while the four bytes are read; retry when
+    // a borrow reached timer B or the high byte of timer A meanwhile.
+    do {
+        b_hi = PEEK(CIA2_TB_HI);
+        b_lo = PEEK(CIA2_TB_LO);
+        a_hi = PEEK(CIA2_TA_HI);
+        a_lo = PEEK(CIA2_TA_LO);
+    } while (PEEK(CIA2_TA_HI) != a_hi ||
+             PEEK(CIA2_TB_LO) != b_lo ||
+             PEEK(CIA2_TB_HI) != b_hi);
+
+    return ~(((unsigned long)b_hi << 24) |
+             ((unsigned long)b_lo << 16) |
+             ((unsigned int)a_hi << 8) |
+             a_lo);
+}
@@ -0,0 +1,20 @@
+#ifndef CYCLE_TIMER_H
+#define CYCLE_TIMER_H
+
+/*
+ * CIA2 timers A and B are free while RS-232 is idle. Timer B counts timer A
+ * underflows, giving a free-running 32-bit cycle counter. The CIAs run from
+ * the 1 MHz system clock in both FAST and SLOW mode (about 3% off on
+ * PAL/NTSC). CIA1 timer A drives the kernal IRQ and keyboard scan, so it
+ * cannot be used here.
+ */
+#define CIA_CYCLES_PER_SEC  1000000UL
+
+// Starts the counter unless it is already running
+void cycle_timer_run(void);
+
+// Cycles counted since the counter was started; differences of two reads
+// give elapsed time, wrapping after about 71 minutes
+unsigned long cycle_timer_read(void);
+
+#endif
@@ -0,0 +1,169 @@
+//   _____  ___________              _______________
+//   __  / / /__  /_  /_____________ __|__  /_  ___/
+//   _  / / /__  /_  __/_  ___/  __ `/__/_ <_  __ \
+//   / /_/ / _  / / /_ _  /   / /_/ /____/ // /_/ /
+//   \____/  /_/  \__/ /_/    \__,_/ /____/ \____/
+// Ultra-36 Rom Switcher for Commodore 128 - C128 Menu Program - display.c
+// Free for personal use.
+// Commercial use or resale (in whole or part) prohibited without permission.
+// (c) 2025 Lukasz Dziwosz / LukasSoft. All Rights Reserved.
+
+#include <c128.h>
+#include <peekpoke.h>
+#include <string.h>
+#include "display.h"
+#include "vdc_fast.h"
+
+#ifdef BENCH
+// sim65 has no VIC; the 40-column backend draws into buffers in bench_stubs.c
+extern unsigned char bench_vic_screen[];
+extern unsigned char bench_vic_colour[];
+#define VIC_SCREEN          bench_vic_screen
+#define VIC_COLOUR          bench_vic_colour
+#else
+#define VIC_SCREEN          ((unsigned char *)0x0400)
+#define VIC_COLOUR          COLOR_RAM
+#endif
+
+#define VIC_RASTER          0xD012
+#define VIC_BLANK_LINE      0xFB
+#define VDC_STATUS_VBLANK   0x20
+
+#define DISPLAY_ROW_OFFSETS(w) {                                        \
+    0 * (w),  1 * (w),  2 * (w),  3 * (w),  4 * (w),  5 * (w),  6 * (w), \
+    7 * (w),  8 * (w),  9 * (w), 10 * (w), 11 * (w), 12 * (w), 13 * (w), \
+   14 * (w), 15 * (w), 16 * (w), 17 * (w), 18 * (w), 19 * (w), 20 * (w), \
+   21 * (w), 22 * (w), 23 * (w), 24 * (w) }
+
+static const unsigned int vic_rows[DISPLAY_ROWS] = DISPLAY_ROW_OFFSETS(40);
+static const unsigned int vdc_rows[DISPLAY_ROWS] = DISPLAY_ROW_OFFSETS(80);
+
+const struct display_driver *display;
+
+unsigned char __fastcall__ display_screen_code(unsigned char c)
+{
+    if (c < 0x40)
+        return c;
+    if (c < 0x60)
+        return c - 0x40;
+    if (c < 0x80)
+        return c - 0x20;
+    if (c < 0xC0)
+        return c - 0x40;
+    return c - 0x80;
+}
+
+// --- VIC-II: 40 columns, screen RAM $0400, colour RAM $D800 ---
+
+static void vic_fill(unsigned int offset, unsigned char code,
+                     unsigned int count)
+{
+    memset(VIC_SCREEN + offset, code, count);
+}
+
+static void vic_put_span(unsigned int offset, const unsigned char *codes,
+                         unsigned char count)
+{
+    memcpy(VIC_SCREEN + offset, codes, count);
+}
+
+static void vic_set_colour(unsigned int offset, unsigned char colour,
+                           unsigned int count)
+{
+    memset(VIC_COLOUR + offset, colour, count);
+}
+
+// One overlapping memmove() each for screen and colour RAM
+static void vic_move_rows(unsigned char top, unsigned char rows,
+                          unsigned char up)
+{
+    unsigned int dest = vic_rows[top];
+    unsigned int size = vic_rows[rows - 1];
+
+    if (up)
+    {
+        memmove(VIC_SCREEN + dest, VIC_SCREEN + dest + 40, size);
+        memmove(VIC_COLOUR + dest, VIC_COLOUR + dest + 40, size);
+    }
+    else
+    {
+        memmove(VIC_SCREEN + dest + 40, VIC_SCREEN + dest, size);
+        memmove(VIC_COLOUR + dest + 40, VIC_COLOUR + dest, size);
+    }
+}
+
+static void vic_wait_blank(void)
+{
+    while (PEEK(VIC_RASTER) == VIC_BLANK_LINE) {}
+    while (PEEK(VIC_RASTER) != VIC_BLANK_LINE) {}
+}
+
+static const struct display_driver vic_driver = {
+    40, 20, vic_rows,
+    vic_fill, vic_put_span, vic_set_colour, vic_move_rows, vic_wait_blank
+};
+
+// --- VDC: 80 columns, kernal editor layout in VDC RAM ---
+
+static void vdc_fill_codes(unsigned int offset, unsigned char code,
+                           unsigned int count)
+{
+    vdc_fill(VDC_SCREEN_RAM + offset, code, count);
+}
+
+static void vdc_put_span(unsigned int offset, const unsigned char *codes,
+                         unsigned char count)
+{
+    vdc_set_address(VDC_SCREEN_RAM + offset);
+    vdc_write_run(codes, count);
+}
+
+static void vdc_set_colour(unsigned int offset, unsigned char colour,
+                           unsigned int count)
+{
+    vdc_fill(VDC_ATTR_RAM + offset, VDC_ATTR_ALTCHARSET | vdc_rgbi[colour],
+             count);
+}
+
+// A VDC block copy per row, in the direction of travel so no row is
+// overwritten before it has been moved
+static void vdc_move_rows(unsigned char top, unsigned char rows,
+                          unsigned char up)
+{
+    unsigned char row;
+    unsigned int dest;
+    unsigned int source;
+
+    for (row = 0; row < rows - 1; row++)
+    {
+        if (up)
+        {
+            dest = vdc_rows[top + row];
+            source = dest + 80;
+        }
+        else
+        {
+            dest = vdc_rows[top + rows - 1 - row];
+            source = dest - 80;
+        }
+        vdc_copy(VDC_SCREEN_RAM + dest, VDC_SCREEN_RAM + source, 80);
+        vdc_copy(VDC_ATTR_RAM + dest, VDC_ATTR_RAM + source, 80);
+    }
+}
+
+static void vdc_wait_blank(void)
+{
+    while (VDC.ctrl & VDC_STATUS_VBLANK) {}
+    while (!(VDC.ctrl & VDC_STATUS_VBLANK)) {}
+}
+
+static const struct display_driver vdc_driver = {
+    80, 40, vdc_rows,
+    vdc_fill_codes, vdc_put_span, vdc_set_colour, vdc_move_rows,
+    vdc_wait_blank
+};
+
+void __fastcall__ display_init(unsigned char vdc_active)
+{
+    display = vdc_active ? &vdc_driver : &vic_driver;
+}
@@ -0,0 +1,43 @@
+#ifndef DISPLAY_H
+#define DISPLAY_H
+
+/*
+ * Display driver for the text screen, bound once at startup from the
+ * kernal's active screen ($00EE). The VIC-II backend writes screen and
+ * colour RAM directly, the VDC backend uses the block writes in vdc_fast.s.
+ * Cells are addressed by row_offset[y] + x; colours are conio COLOR_*
+ * numbers and reversed cells have DISPLAY_REVERSE set in the screen code,
+ * as the kernal editor does on both chips.
+ */
+#define DISPLAY_ROWS            25
+#define DISPLAY_REVERSE         0x80
+#define DISPLAY_SPACE           0x20    // Screen code of a blank cell
+
+struct display_driver {
+    // Layout of this screen width
+    unsigned char width;
+    unsigned char half;                 // First column of the right half
+    const unsigned int *row_offset;     // DISPLAY_ROWS cell offsets
+
+    // Screen codes only: count copies of code / a run of codes
+    void (*fill)(unsigned int offset, unsigned char code, unsigned int count);
+    void (*put_span)(unsigned int offset, const unsigned char *codes,
+                     unsigned char count);
+    // Colour (VIC colour RAM, VDC attribute) of count cells
+    void (*set_colour)(unsigned int offset, unsigned char colour,
+                       unsigned int count);
+    // Shifts rows top..top+rows-1 one row up or down, colours included
+    void (*move_rows)(unsigned char top, unsigned char rows, unsigned char up);
+    // Returns at the start of the vertical blank, so the writes that
+    // follow land off screen
+    void (*wait_blank)(void);
+};
+
+extern const struct display_driver *display;
+
+void __fastcall__ display_init(unsigned char vdc_active);
+
+// PETSCII (lowercase character set) to screen code
+unsigned char __fastcall__ display_screen_code(unsigned char c);
+
+#endif
@@ -0,0 +1,10 @@
+#ifndef HIGH_ROM_H
+#define HIGH_ROM_H
+
+#include <stddef.h>
+
+// memcpy() with the menu's upper ROM ($C000-$FEFF) mapped in. Interrupts are
+// held off for the copy because the kernal is banked out meanwhile.
+void* __fastcall__ high_rom_copy(void *dest, const void *src, size_t count);
+
+#endif
@@ -9,15 +9,27 @@
 // (c) 2025 Lukasz Dziwosz / LukasSoft. All Rights Reserved.
 
 #include <stdio.h>
-#include <unistd.h>
 #include <stdlib.h>
 #include <string.h>
 #include <conio.h>
 #include <peekpoke.h>
 #include <c128.h>
 
+#ifdef VDC_PAGE
 #include "vdc_info_screen.h"
+#endif
+#ifdef SID_PAGE
 #include "sid_info_screen.h"
+#endif
+#include "rom_catalog.h"
+#include "name_table.h"
+#include "warm_state.h"
+#include "profile.h"
+#include "redraw.h"
+#include "display.h"
+#include "ui_strings.h"
+#include "rom_check.h"
+#include "scheduler.h"
 
 #define APP_VERSION "1.0.0"
 
@@ -34,18 +46,51 @@
 #define CMD_BANK_PREFIX 0xA0
 #define CMD_JIFFY_PREFIX 0xB0
 #define CMD_TEMP_BANK_PREFIX 0xD0
+// Latch firmware only (LINK_LATCHES): prefixes held for the next 0xA0
+#define CMD_BANK_HIGH_PREFIX 0xC0 // Bank bits 4-7
+#define CMD_BANK_HALF_PREFIX 0xE0 // 1 = lower, 2 = upper 16K only
 #define HALF_CYCLE_DELAY 20
-#define ACK_TIMEOUT_STEPS 1500
+#define ACK_TIMEOUT_TICKS 36 // Over the ATtiny's 500 ms worst case
+
+// serial_task() progress through one command byte
+#define LINK_SEND 0    // Clock the byte out, wait for data released
+#define LINK_ACK 1     // Wait for the ATtiny to pull data low
+#define LINK_RELEASE 2 // Wait for it to let go again
+
+// link_poll() results
+#define LINK_WAITING 0
+#define LINK_ACKED 1
+#define LINK_FAILED 2
 
 typedef int bool;
 #define true 1
 #define false 0
 
+// redraw_task() work: the current page, or the page and both key bars
+#define REDRAW_NONE 0
+#define REDRAW_PAGE 1
+#define REDRAW_BARS 2
+
+// Bank list panel: rows 5-12, row 13 holds the ROM details
+#define LIST_TOP 5
+#define LIST_ROWS 8
+
 // Forward declarations
 int mainmenu();
-bool send_tiny_command(unsigned char opcode, unsigned char value);
+void input_task(void);
+void redraw_task(void);
+void serial_task(void);
+void status_task(void);
+void queue_command(unsigned char opcode, unsigned char value,
+                   const char *message, const char *done);
+void dispatch_key(unsigned char key);
+void serial_finish(bool acknowledged);
+bool link_prepare(unsigned char opcode, unsigned char value);
+bool link_send(void);
+unsigned char link_poll(void);
+bool link_unlatch(void);
+void link_restore(void);
 void send_byte(unsigned char value, unsigned char *port_value);
-bool send_command(unsigned char command);
 void delay_units(unsigned int count);
 void draw_title_bar(void);
 void draw_fkey_bar(void);
@@ -54,10 +99,23 @@ void draw_options_initial(const char *options[], int count, int selected);
 void draw_options_colors(int count, int selected);
 void draw_option(int option_num, int total_count, int is_selected);
 void get_item_position(unsigned char item_index, int total_count, unsigned char *x, unsigned char *y);
+bool list_is_virtual(int count);
+unsigned char list_follow(int count, int selected);
+void scroll_list_rows(bool up);
+void draw_list_markers(int count);
+void reset_rom_view(void);
+bool filter_rom_view(unsigned char length);
+bool edit_rom_filter(unsigned char key);
+void draw_filter_prompt(void);
+void draw_rom_list(int selected);
+void remember_menu_state(void);
+void draw_current_screen(void);
 int handle_selection(int selected, int max_items, unsigned char key);
 void draw_rom_screen(int selected);
+void draw_rom_details(int selected);
 void draw_jiffy_screen(int selected);
 void draw_info_screen(void);
+void verify_menu_image(void);
 void show_status_message(const char *message, unsigned char color,
                          unsigned char seconds);
 void on_screen_instructions(const bool isJiffy);
@@ -72,29 +130,43 @@ unsigned char SCREENW;
 int current_screen = 0; // 0=ROM, 1=JiffyDOS, 2=Info
 int previous_screen = 0;
 bool basic_reset_armed = false;
+unsigned char list_top = 0; // First visible entry of a scrolling list
+int list_drawn_selected = -1; // Entry last drawn highlighted
 
-#ifdef ONLINE_BUILD
-#include "online_rom_config.h"
-#endif
+// Menu state shared by the scheduler tasks
+int rom_selected;
+int jiffy_selected;
+unsigned char redraw_request = REDRAW_NONE;
+unsigned char status_seconds; // Until the status task clears row 21
 
-#ifndef USER_ROM_NAMES_INIT
-#error USER_ROM_NAMES_INIT must define the 6 or 14 user-selectable ROM names
-#endif
-
-#ifndef NUM_USER_ROMS
-#error NUM_USER_ROMS must be set to 6 or 14
+// Ultra-36 command for the serial task, and how far it has got
+struct
+{
+    unsigned char opcode;
+    const char *done;        // Status text once acknowledged
+    unsigned char bytes[3];  // Latch prefixes first, then the command
+    unsigned char count;
+    unsigned char next;      // Byte being sent
+    unsigned char phase;     // LINK_SEND, LINK_ACK or LINK_RELEASE
+    unsigned char since;     // Tick the current wait began
+    unsigned int polls;      // Acknowledge polls so far
+    unsigned char saved_port;
+    unsigned char saved_ddr;
+#ifdef LINK_LATCHES
+    bool unlatching;         // Sending prefix | 0 after a failed command
 #endif
+} serial_request;
 
-#if NUM_USER_ROMS != 6 && NUM_USER_ROMS != 14
-#error NUM_USER_ROMS must be exactly 6 (8 banks) or 14 (16 banks)
-#endif
+// Bank labels come from the patchable name table (name_table.c)
+const char *romNames[MAX_ROMS];
+unsigned char rom_count;
 
-/*
- * Bank 0 contains this menu program. Bank 1 must always be the empty bank,
- * so its label is a firmware invariant rather than part of build input.
- */
-#define NUM_ROMS (NUM_USER_ROMS + 1)
-const char *romNames[] = {"Empty_Bank", USER_ROM_NAMES_INIT};
+// The ROM list shows romNames[rom_view[i]]: every bank, or the banks whose
+// label starts with rom_filter
+unsigned char rom_view[MAX_ROMS];
+unsigned char rom_view_count;
+char rom_filter[NAME_TABLE_NAME_SIZE];
+unsigned char rom_filter_length;
 
 const char *jiffyOptions[] = {
     "JiffyDOS ON",
@@ -105,26 +177,76 @@ const char *fkeyLabels[] = {
     " F2 JIFFY ",
     " F3 INFO "};
 
+// Bottom bar shortcuts, in the left or right half of rows 23-24
+struct util_key
+{
+    const char *cap;
+    const char *label;
+    unsigned char y;
+    unsigned char right;
+};
+
+const struct util_key utilKeys[] = {
+    {" F4 ", " C64", 23, 0},
+    {" F5 ", " Restart", 23, 1},
+#ifdef VDC_PAGE
+    {" F6 ", " VDC Info", 24, 0},
+#endif
+#ifdef SID_PAGE
+    {" F7 ", " SID Info", 24, 1},
+#endif
+};
+
+#define UTIL_KEY_COUNT (sizeof(utilKeys) / sizeof(utilKeys[0]))
+
+// Fixed texts of the ROM/JiffyDOS help and the info page
+const struct ui_line pageHelp[] = {
+    {2, 15, COLOR_GRAY3, UI_HELP_SELECT},
+    {2, 16, COLOR_GRAY3, UI_HELP_SAVED},
+    {2, 17, COLOR_LIGHTGREEN, UI_HELP_HOLD_RESET},
+    {2, 18, COLOR_GRAY3, UI_HELP_EMPTY_BANK}};
+
+const struct ui_line infoAbout[] = {
+    {2, 5, COLOR_WHITE, UI_INFO_TAGLINE},
+    {2, 6, COLOR_WHITE, UI_INFO_VERSION},
+    {2, 8, COLOR_WHITE, UI_INFO_BANKS},
+    {2, 9, COLOR_WHITE, UI_INFO_JIFFY},
+    {2, 10, COLOR_WHITE, UI_INFO_SCREENS},
+    {2, 12, COLOR_WHITE, UI_INFO_REMEMBERED}};
+
+const struct ui_line infoKeys[] = {
+    {2, 15, COLOR_GRAY3, UI_INFO_KEYS_SECTIONS},
+    {2, 16, COLOR_GRAY3, UI_INFO_KEYS_MOVE},
+    {2, 17, COLOR_GRAY3, UI_INFO_KEYS_VERIFY},
+    {2, 18, COLOR_LIGHTGREEN, UI_INFO_RESET}};
+
 int main(void)
 {
     int result;
 
-    // Detect screen width (VIC or VDC)
-    if (PEEK(0x00EE) == 79)
+    // Bind the display driver for the active screen (VIC or VDC)
+    display_init(PEEK(0x00EE) == 79);
+    SCREENW = display->width;
+    if (SCREENW == 80)
     {
-        SCREENW = 80;
         fast();
         bgcolor(COLOR_BLUE);
     }
     else
     {
-        SCREENW = 40;
         bgcolor(COLOR_BLUE);
         bordercolor(COLOR_BLUE);
     }
+    redraw_init(SCREENW == 40);
 
     clrscr();
 
+    rom_count = load_rom_names(romNames);
+    reset_rom_view();
+    warm_state_restore(rom_count);
+#ifdef PROFILE
+    profile_init();
+#endif
     result = mainmenu();
 
     // Clean up before exit
@@ -143,45 +265,103 @@ void delay_units(unsigned int count)
     }
 }
 
-bool send_tiny_command(unsigned char opcode, unsigned char value)
+/* Turns a menu opcode into the command bytes serial_task() sends. Returns
+ * false for a request the Ultra-36 has no command for. */
+bool link_prepare(unsigned char opcode, unsigned char value)
 {
-    unsigned char command;
+    unsigned char bank;
 
-    if (opcode == SERIAL_OPCODE_BANK && value <= 15)
-        command = CMD_BANK_PREFIX | value;
+    serial_request.count = 0;
+    if (opcode == SERIAL_OPCODE_BANK)
+    {
+        /* 'value' is a name table slot: bank 0-63 plus an optional 16K
+         * half. Banks above 15 need their high nibble latched first and a
+         * packed ROM its half. The ATtiny clears both latches after every
+         * bank command, so 8 and 16 bank boards keep seeing the original
+         * single byte. */
+        bank = value & ROM_SLOT_BANK;
+#ifndef LINK_LATCHES
+        // Plain firmware: whole banks 0-15 only, one $A0 byte each
+        if (value > 15)
+            return false;
+#endif
+        if (bank > 15)
+            serial_request.bytes[serial_request.count++] =
+                CMD_BANK_HIGH_PREFIX | (bank >> 4);
+        if (value & ROM_SLOT_HALF)
+            serial_request.bytes[serial_request.count++] =
+                CMD_BANK_HALF_PREFIX | (value >> 6);
+        serial_request.bytes[serial_request.count++] =
+            CMD_BANK_PREFIX | (bank & 0x0F);
+    }
     else if (opcode == SERIAL_OPCODE_JIFFY && value <= 1)
-        command = CMD_JIFFY_PREFIX | value;
+        serial_request.bytes[serial_request.count++] = CMD_JIFFY_PREFIX | value;
     else if (opcode == SERIAL_OPCODE_TEMP_BANK && value == 1)
-        command = CMD_TEMP_BANK_PREFIX | value;
+        serial_request.bytes[serial_request.count++] =
+            CMD_TEMP_BANK_PREFIX | value;
     else
         return false;
 
-    return send_command(command);
+    serial_request.next = 0;
+    serial_request.phase = LINK_SEND;
+#ifdef LINK_LATCHES
+    serial_request.unlatching = false;
+#endif
+    return true;
 }
 
-bool send_command(unsigned char command)
+/* After a failure, queues prefix | 0 for every latch the ATtiny already
+ * acknowledged, so a half-sent bank command cannot leave the high nibble or
+ * half latched for the next one. Returns false when there is nothing to
+ * clear, or when the failure was in the clearing itself. */
+bool link_unlatch(void)
+{
+#ifdef LINK_LATCHES
+    unsigned char i;
+
+    // Everything before the command byte is a prefix: bytes[0..next-1]
+    if (serial_request.unlatching || serial_request.next == 0)
+        return false;
+    for (i = 0; i < serial_request.next; i++)
+        serial_request.bytes[i] &= 0xF0;
+    serial_request.count = serial_request.next;
+    serial_request.next = 0;
+    serial_request.phase = LINK_SEND;
+    serial_request.unlatching = true;
+    return true;
+#else
+    return false;
+#endif
+}
+
+/* Clocks out the next command byte and waits for the ATtiny to release the
+ * data line, which it does within a few hundred microseconds. These are the
+ * edges it samples, so this part runs in one piece; the port stays set up
+ * for the acknowledge that link_poll() waits for. */
+bool link_send(void)
 {
-    unsigned char saved_port;
-    unsigned char saved_ddr;
     unsigned char port_value;
     unsigned int timeout;
-    bool acknowledged = false;
     bool data_released = false;
 
-    saved_port = PEEK(CIA2_PRB);
-    saved_ddr = PEEK(CIA2_DDRB);
+    PROFILE_ENTER(PROF_SEND_COMMAND);
+    // The bit delays are CPU loops; keep them at the menu's base speed
+    redraw_pause();
+    serial_request.saved_port = PEEK(CIA2_PRB);
+    serial_request.saved_ddr = PEEK(CIA2_DDRB);
 
-    port_value = saved_port | SERIAL_DATA_MASK | SERIAL_CLOCK_MASK;
+    port_value = serial_request.saved_port | SERIAL_DATA_MASK | SERIAL_CLOCK_MASK;
     POKE(CIA2_PRB, port_value);
-    POKE(CIA2_DDRB, saved_ddr | SERIAL_DATA_MASK | SERIAL_CLOCK_MASK);
+    POKE(CIA2_DDRB,
+         serial_request.saved_ddr | SERIAL_DATA_MASK | SERIAL_CLOCK_MASK);
     delay_units(HALF_CYCLE_DELAY * 10);
 
-    send_byte(command, &port_value);
+    send_byte(serial_request.bytes[serial_request.next], &port_value);
 
     port_value &= (unsigned char)~SERIAL_CLOCK_MASK;
     POKE(CIA2_PRB, port_value);
     POKE(CIA2_DDRB,
-         (saved_ddr | SERIAL_CLOCK_MASK) &
+         (serial_request.saved_ddr | SERIAL_CLOCK_MASK) &
          (unsigned char)~SERIAL_DATA_MASK);
 
     for (timeout = 0; timeout < 300; timeout++)
@@ -195,36 +375,52 @@ bool send_command(unsigned char command)
     }
 
     if (!data_released)
-    {
-        POKE(CIA2_PRB, saved_port);
-        POKE(CIA2_DDRB, saved_ddr);
-        return false;
-    }
+        link_restore();
 
-    for (timeout = 0; timeout < ACK_TIMEOUT_STEPS; timeout++)
-    {
-        if ((PEEK(CIA2_PRB) & SERIAL_DATA_MASK) == 0)
-        {
-            acknowledged = true;
-            break;
-        }
-        delay_units(HALF_CYCLE_DELAY);
-    }
+    redraw_resume();
+    PROFILE_LEAVE(PROF_SEND_COMMAND);
+    return data_released;
+}
 
-    if (acknowledged)
+/* Waits for the acknowledge pulse (data pulled low) and its end. The pulse
+ * is only a few milliseconds long, so each run polls without a break until
+ * the next tick starts and then returns; the scheduler calls it again
+ * straight after the cheap tasks behind it. Gives up ACK_TIMEOUT_TICKS
+ * after the wait began. */
+unsigned char link_poll(void)
+{
+    unsigned char tick = scheduler_ticks();
+
+    do
     {
-        for (timeout = 0; timeout < ACK_TIMEOUT_STEPS; timeout++)
+        if (serial_request.phase == LINK_ACK)
         {
-            if (PEEK(CIA2_PRB) & SERIAL_DATA_MASK)
-                break;
-            delay_units(HALF_CYCLE_DELAY);
+            if ((PEEK(CIA2_PRB) & SERIAL_DATA_MASK) == 0)
+            {
+                warm_state.ack_steps = serial_request.polls;
+                warm_state_seal();
+                serial_request.phase = LINK_RELEASE;
+                serial_request.since = tick;
+            }
         }
-    }
+        else if (PEEK(CIA2_PRB) & SERIAL_DATA_MASK)
+            return LINK_ACKED;
+        serial_request.polls++;
+        delay_units(HALF_CYCLE_DELAY);
+    } while (scheduler_ticks() == tick);
 
-    POKE(CIA2_PRB, saved_port);
-    POKE(CIA2_DDRB, saved_ddr);
+    if ((unsigned char)(scheduler_ticks() - serial_request.since) <
+        ACK_TIMEOUT_TICKS)
+        return LINK_WAITING;
+    // A pulse that never ends still counts as acknowledged
+    return serial_request.phase == LINK_RELEASE ? LINK_ACKED : LINK_FAILED;
+}
 
-    return acknowledged;
+// Hands the User Port lines back as they were before the byte
+void link_restore(void)
+{
+    POKE(CIA2_PRB, serial_request.saved_port);
+    POKE(CIA2_DDRB, serial_request.saved_ddr);
 }
 
 void send_byte(unsigned char value, unsigned char *port_value)
@@ -251,151 +447,337 @@ void send_byte(unsigned char value, unsigned char *port_value)
 
 int mainmenu()
 {
-    int rom_selected = 0;
-    int jiffy_selected = 0;
-    unsigned char key;
+    // Pick up where the last session left off (warm_state.c)
+    rom_selected = warm_state.rom_selected;
+    jiffy_selected = warm_state.jiffy_selected;
+    current_screen = warm_state.screen;
 
     // Draw static elements
     draw_title_bar();
     draw_fkey_bar();
     draw_util_bar();
-
-    // Start with ROM selection screen
-    current_screen = 0;
-    draw_rom_screen(rom_selected);
+    draw_current_screen();
+
+    // Every tick: keys first, then the work they queued
+    scheduler_init();
+    task_define(TASK_INPUT, input_task, 1, 4);
+    task_define(TASK_REDRAW, redraw_task, 1, 30);
+    task_define(TASK_SERIAL, serial_task, 1, 2);
+    task_define(TASK_STATUS, status_task, TICKS_PER_SECOND, 1);
+#ifdef SID_PAGE
+    task_define(TASK_SID, sid_play_task, 1, 1);
+#endif
+    task_start(TASK_INPUT);
+    task_start(TASK_REDRAW);
 
     while (1)
+        scheduler_step();
+
+    return 0;
+}
+
+/* Takes one key per tick. Keys wait in the kernal buffer while a page
+ * repaint or an Ultra-36 command is still outstanding, so they always act
+ * on what is on screen. */
+void input_task(void)
+{
+    unsigned char key;
+
+    if (redraw_request != REDRAW_NONE || tasks[TASK_SERIAL].started ||
+        !kbhit())
+        return;
+
+    key = cgetc();
+    if (basic_reset_armed)
+        return;
+
+#ifdef PROFILE
+    if (key == CH_PROFILE)
     {
-        key = cgetc();
+        draw_profile_screen(SCREENW);
+        redraw_request = REDRAW_BARS;
+        return;
+    }
+#endif
+    PROFILE_ENTER(PROF_DISPATCH);
+    dispatch_key(key);
+    remember_menu_state();
+    PROFILE_LEAVE(PROF_DISPATCH);
+}
 
-        if (basic_reset_armed)
-            continue;
+void redraw_task(void)
+{
+    if (redraw_request == REDRAW_NONE)
+        return;
 
-        // Handle F-key navigation first
-        switch (key)
+    // The SID page draws its own title bar and owns the bottom rows
+    if (current_screen != 4)
+    {
+        draw_fkey_bar();
+        if (redraw_request == REDRAW_BARS)
+            draw_util_bar();
+    }
+    redraw_request = REDRAW_NONE;
+    draw_current_screen();
+}
+
+/* Sends the queued command bytes one after the other. Each run either
+ * clocks a byte out or polls for its acknowledge up to the next tick, so a
+ * slow ATtiny no longer holds up the other tasks. */
+void serial_task(void)
+{
+    unsigned char result;
+
+    if (serial_request.phase == LINK_SEND)
+    {
+        if (!link_send())
+        {
+            if (!link_unlatch())
+                serial_finish(false);
+            return;
+        }
+        serial_request.phase = LINK_ACK;
+        serial_request.since = scheduler_ticks();
+        serial_request.polls = 0;
+    }
+
+    result = link_poll();
+    if (result == LINK_WAITING)
+        return;
+    link_restore();
+    if (result == LINK_FAILED)
+    {
+        if (!link_unlatch())
+            serial_finish(false);
+        return;
+    }
+
+    if (++serial_request.next < serial_request.count)
+        serial_request.phase = LINK_SEND;
+#ifdef LINK_LATCHES
+    else if (serial_request.unlatching)
+        serial_finish(false); // Latches clear, the command still failed
+#endif
+    else
+        serial_finish(true);
+}
+
+// Ends the transaction and reports how it went
+void serial_finish(bool acknowledged)
+{
+    task_stop(TASK_SERIAL);
+    if (!acknowledged)
+    {
+        show_status_message("ERROR: Ultra36 did not acknowledge.", COLOR_LIGHTRED, 3);
+        return;
+    }
+
+    if (serial_request.opcode == SERIAL_OPCODE_TEMP_BANK)
+    {
+        basic_reset_armed = true;
+        show_status_message(serial_request.done, COLOR_LIGHTGREEN, 3);
+    }
+    else
+        show_status_message(serial_request.done, COLOR_LIGHTGREEN, 2);
+}
+
+// Clears the status line once its message has been up long enough
+void status_task(void)
+{
+    if (--status_seconds != 0)
+        return;
+    task_stop(TASK_STATUS);
+    fill_line(21, COLOR_BLUE, 0);
+}
+
+// Shows 'message' while the serial task sends the command next tick
+void queue_command(unsigned char opcode, unsigned char value,
+                   const char *message, const char *done)
+{
+    show_status_message(message, COLOR_CYAN, 0);
+    serial_request.opcode = opcode;
+    serial_request.done = done;
+    if (!link_prepare(opcode, value))
+    {
+        show_status_message("ERROR: Ultra36 firmware cannot select this.",
+                            COLOR_LIGHTRED, 3);
+        return;
+    }
+    task_start(TASK_SERIAL);
+}
+
+void dispatch_key(unsigned char key)
+{
+#ifdef SID_PAGE
+    if (current_screen == 4)
+    {
+        // The SID page takes every key until F8 hands the screen back
+        if (sid_info_key(key))
         {
-        case CH_F1:
-            if (current_screen != 0)
-            {
-                current_screen = 0;
-                draw_fkey_bar();
-                draw_rom_screen(rom_selected);
-            }
-            continue;
-        case CH_F2:
-            if (current_screen != 1)
-            {
-                current_screen = 1;
-                draw_fkey_bar();
-                draw_jiffy_screen(jiffy_selected);
-            }
-            continue;
-        case CH_F3:
-            if (current_screen != 2)
-            {
-                current_screen = 2;
-                draw_fkey_bar();
-                draw_info_screen();
-            }
-            continue;
-        case CH_F4:
-            show_status_message("Switching to C64 Mode...", COLOR_LIGHTGREEN, 2);
-            clrscr();
-            c64mode(); // Goodbay folks
-            break;
-        case CH_F5:
-            show_status_message("Preparing BASIC...", COLOR_CYAN, 1);
-            if (send_tiny_command(SERIAL_OPCODE_TEMP_BANK, 1))
-            {
-                basic_reset_armed = true;
-                show_status_message("BASIC armed. Press RESET.", COLOR_LIGHTGREEN, 3);
-            }
-            else
-                show_status_message("ERROR: Ultra36 did not acknowledge.", COLOR_LIGHTRED, 3);
-            continue;
-        case CH_F6:
-            current_screen = 3;
-            draw_fkey_bar();
-            draw_vdc_info_screen(SCREENW);
-            break;
-        case CH_F7:
-            previous_screen = current_screen;
-            current_screen = 4;
-            draw_sid_info_screen(SCREENW);
             current_screen = previous_screen;
-            draw_fkey_bar();
-            draw_util_bar();
-            switch (current_screen)
-            {
-            case 0:
-                draw_rom_screen(rom_selected);
-                break;
-            case 1:
-                draw_jiffy_screen(jiffy_selected);
-                break;
-            case 2:
-                draw_info_screen();
-                break;
-            case 3:
-                draw_vdc_info_screen(SCREENW);
-                break;
-            }
-            break;
+            redraw_request = REDRAW_BARS;
         }
+        return;
+    }
+#endif
 
-        // Handle screen-specific navigation
-        switch (current_screen)
+    // Handle F-key navigation first
+    switch (key)
+    {
+    case CH_F1:
+        if (current_screen != 0)
         {
-        case 0: // ROM selection
-            if (key == CH_ENTER)
-            {
-                char buffer[40];
-                sprintf(buffer, "Sending %s...", romNames[rom_selected]);
-                show_status_message(buffer, COLOR_CYAN, 1);
-                if (send_tiny_command(SERIAL_OPCODE_BANK, rom_selected + 1))
-                    show_status_message("Saved. Reset to activate ROM bank.", COLOR_LIGHTGREEN, 2);
-                else
-                    show_status_message("ERROR: Ultra36 did not acknowledge.", COLOR_LIGHTRED, 3);
-            }
-            {
-                int old_selected = rom_selected;
-                rom_selected = handle_selection(rom_selected, NUM_ROMS, key);
-                if (old_selected != rom_selected)
-                {
-                    draw_options_colors(NUM_ROMS, rom_selected); // Only update colors!
-                }
-            }
-            break;
+            current_screen = 0;
+            redraw_request = REDRAW_PAGE;
+        }
+        return;
+    case CH_F2:
+        if (current_screen != 1)
+        {
+            current_screen = 1;
+            redraw_request = REDRAW_PAGE;
+        }
+        return;
+    case CH_F3:
+        if (current_screen != 2)
+        {
+            current_screen = 2;
+            redraw_request = REDRAW_PAGE;
+        }
+        return;
+    case CH_F4:
+        show_status_message("Switching to C64 Mode...", COLOR_LIGHTGREEN, 0);
+        scheduler_wait(2 * TICKS_PER_SECOND);
+        clrscr();
+        c64mode(); // Goodbay folks
+        break;
+    case CH_F5:
+        queue_command(SERIAL_OPCODE_TEMP_BANK, 1, "Preparing BASIC...",
+                      "BASIC armed. Press RESET.");
+        return;
+#ifdef VDC_PAGE
+    case CH_F6:
+        current_screen = 3;
+        redraw_request = REDRAW_PAGE;
+        return;
+#endif
+#ifdef SID_PAGE
+    case CH_F7:
+        previous_screen = current_screen;
+        current_screen = 4;
+        redraw_request = REDRAW_PAGE;
+        return;
+#endif
+    }
 
-            // Case 1: JiffyDOS toggle - replace the draw_options call
-        case 1: // JiffyDOS toggle
-            if (key == CH_ENTER)
+    // Handle screen-specific navigation
+    switch (current_screen)
+    {
+    case 0: // ROM selection
+        if (key == CH_ENTER)
+        {
+            char buffer[40];
+            sprintf(buffer, "Sending %s...", romNames[rom_view[rom_selected]]);
+            queue_command(SERIAL_OPCODE_BANK, rom_slot(rom_view[rom_selected]),
+                          buffer, "Saved. Reset to activate ROM bank.");
+        }
+        else if (edit_rom_filter(key))
+        {
+            // Only the prompt and the list rows change
+            rom_selected = 0;
+            draw_filter_prompt();
+            draw_rom_list(rom_selected);
+            draw_rom_details(rom_view[rom_selected]);
+            break;
+        }
+        {
+            int old_selected = rom_selected;
+            rom_selected = handle_selection(rom_selected, rom_view_count, key);
+            if (old_selected != rom_selected)
             {
-                show_status_message("Sending JiffyDOS setting...", COLOR_CYAN, 1);
-
-                // jiffy_selected == 0 → ON → pass 1
-                // jiffy_selected == 1 → OFF → pass 0
-                if (send_tiny_command(SERIAL_OPCODE_JIFFY, jiffy_selected == 0 ? 1 : 0))
-                    show_status_message("Saved. Reset to apply JiffyDOS.", COLOR_LIGHTGREEN, 2);
-                else
-                    show_status_message("ERROR: Ultra36 did not acknowledge.", COLOR_LIGHTRED, 3);
+                draw_options_colors(rom_view_count, rom_selected); // Only update colors!
+                draw_rom_details(rom_view[rom_selected]);
             }
+        }
+        break;
+
+        // Case 1: JiffyDOS toggle - replace the draw_options call
+    case 1: // JiffyDOS toggle
+        if (key == CH_ENTER)
+        {
+            // jiffy_selected == 0 → ON → pass 1
+            // jiffy_selected == 1 → OFF → pass 0
+            queue_command(SERIAL_OPCODE_JIFFY, jiffy_selected == 0 ? 1 : 0,
+                          "Sending JiffyDOS setting...",
+                          "Saved. Reset to apply JiffyDOS.");
+        }
+        {
+            int old_selected = jiffy_selected;
+            jiffy_selected = handle_selection(jiffy_selected, 2, key);
+            if (old_selected != jiffy_selected)
             {
-                int old_selected = jiffy_selected;
-                jiffy_selected = handle_selection(jiffy_selected, 2, key);
-                if (old_selected != jiffy_selected)
-                {
-                    draw_options_colors(2, jiffy_selected); // Only update colors!
-                }
+                draw_options_colors(2, jiffy_selected); // Only update colors!
             }
-            break;
-        case 2: // Info screen
-            // Info screen is static, just wait for F-key navigation
-            break;
         }
+        break;
+    case 2: // Info screen
+        if (key == 'v' || key == 'V')
+        {
+            verify_menu_image();
+        }
+        break;
+#ifdef VDC_PAGE
+    case 3: // VDC info screen
+        if (key == CH_ENTER)
+        {
+            draw_vdc_ram_test_busy(SCREENW);
+            run_vdc_ram_test();
+
+            // The 64K test scrambles the kernal's 80-column layout.
+            clrscr();
+            draw_title_bar();
+            redraw_request = REDRAW_BARS;
+        }
+        break;
+#endif
     }
+}
 
-    return 0;
+// Draws the page of current_screen, e.g. after returning from SID setup
+void draw_current_screen(void)
+{
+    switch (current_screen)
+    {
+    case 1:
+        draw_jiffy_screen(jiffy_selected);
+        break;
+    case 2:
+        draw_info_screen();
+        break;
+#ifdef VDC_PAGE
+    case 3:
+        draw_vdc_info_screen(SCREENW);
+        break;
+#endif
+#ifdef SID_PAGE
+    case 4:
+        draw_sid_info_screen(SCREENW);
+        break;
+#endif
+    default:
+        draw_rom_screen(rom_selected);
+        break;
+    }
+}
+
+// Saves the selections and the current menu page for the next reset
+void remember_menu_state(void)
+{
+    warm_state.rom_selected = rom_view[rom_selected];
+    warm_state.jiffy_selected = jiffy_selected;
+    if (current_screen < 3)
+        warm_state.screen = current_screen;
+    warm_state_seal();
 }
 
 void draw_title_bar(void)
@@ -439,18 +821,173 @@ void draw_fkey_bar(void)
 
 void draw_rom_screen(int selected)
 {
-    draw_content_area("Select ROM bank:", romNames, NUM_ROMS, selected);
+    PROFILE_ENTER(PROF_DRAW_ROM_SCREEN);
+    redraw_begin();
+    draw_content_area("Select ROM bank:", romNames, rom_view_count, selected);
+    draw_filter_prompt();
+    draw_rom_details(rom_view[selected]);
+    redraw_end();
+    PROFILE_LEAVE(PROF_DRAW_ROM_SCREEN);
+}
+
+void reset_rom_view(void)
+{
+    unsigned char i;
+
+    for (i = 0; i < rom_count; i++)
+        rom_view[i] = i;
+    rom_view_count = rom_count;
+    rom_filter_length = 0;
+}
+
+/* Shows the banks matching the first 'length' filter characters. The name
+ * table's first-letter index makes this a lookup plus a short narrowing
+ * pass, not a scan of every label. Keeps the old list if nothing matches. */
+bool filter_rom_view(unsigned char length)
+{
+    unsigned char first;
+    unsigned char count;
+    unsigned char i;
+
+    if (length == 0)
+    {
+        reset_rom_view();
+        return true;
+    }
+
+    count = match_rom_names(rom_filter, length, &first);
+    if (count == 0)
+        return false;
+
+    for (i = 0; i < count; i++)
+        rom_view[i] = sorted_rom_name(first + i);
+    rom_view_count = count;
+    rom_filter_length = length;
+    return true;
+}
+
+// Letters, digits and symbols extend the filter, DEL shortens it and HOME
+// clears it. Returns true when the list changed.
+bool edit_rom_filter(unsigned char key)
+{
+    if (key == CH_DEL)
+        return rom_filter_length != 0 && filter_rom_view(rom_filter_length - 1);
+    if (key == CH_HOME)
+        return rom_filter_length != 0 && filter_rom_view(0);
+    if (!((key >= 0x20 && key <= 0x5F) || (key >= 0xC1 && key <= 0xDA)) ||
+        rom_filter_length == NAME_TABLE_NAME_SIZE - 1)
+        return false;
+
+    rom_filter[rom_filter_length] = key;
+    return filter_rom_view(rom_filter_length + 1);
+}
+
+// Search line on the first row of the panel
+void draw_filter_prompt(void)
+{
+    unsigned char i;
+
+    revers(0);
+    cclearxy(1, 4, SCREENW - 2);
+    gotoxy(2, 4);
+    if (rom_filter_length == 0)
+    {
+        textcolor(COLOR_GRAY2);
+        cputs("Type a name to search");
+    }
+    else
+    {
+        textcolor(COLOR_WHITE);
+        cputs("Find: ");
+        for (i = 0; i < rom_filter_length; i++)
+            cputc(rom_filter[i]);
+        textcolor(COLOR_GRAY2);
+        cputs("  DEL/HOME");
+    }
+    textcolor(COLOR_GRAY3);
+}
+
+// Redraws just the list rows after the filter replaced the entries
+void draw_rom_list(int selected)
+{
+    unsigned char y;
+
+    PROFILE_ENTER(PROF_DRAW_ROM_LIST);
+    for (y = LIST_TOP; y < LIST_TOP + LIST_ROWS; y++)
+        cclearxy(1, y, SCREENW - 2);
+    draw_options_initial(romNames, rom_view_count, selected);
+    PROFILE_LEAVE(PROF_DRAW_ROM_LIST);
+}
+
+// One catalog line under the bank list: size, autostart, signature, CRC.
+// ROMs packed into half a bank show which half they live in.
+void draw_rom_details(int selected)
+{
+    struct rom_catalog_entry entry;
+    char buffer[80];
+    const char *mode;
+    const char *size;
+    unsigned char slot;
+
+    PROFILE_ENTER(PROF_DRAW_ROM_DETAILS);
+    cclearxy(1, 13, SCREENW - 2);
+    slot = rom_slot(selected);
+    if (!rom_catalog_read(selected, &entry))
+    {
+        // Without a catalog only packed ROMs have something to show
+        if (slot & ROM_SLOT_HALF)
+            snprintf(buffer, SCREENW - 3, "Bank %u, %s 16K",
+                     slot & ROM_SLOT_BANK,
+                     (slot & ROM_SLOT_UPPER) ? "upper" : "lower");
+        else
+        {
+            PROFILE_LEAVE(PROF_DRAW_ROM_DETAILS);
+            return;
+        }
+    }
+    else if (entry.flags & ROM_CAT_EMPTY)
+    {
+        snprintf(buffer, SCREENW - 3, "Empty bank %08lX", entry.crc);
+    }
+    else
+    {
+        if (entry.cart_mode == 0x00)
+            mode = "no-auto";
+        else if (entry.cart_mode == 0x01)
+            mode = "auto";
+        else
+            mode = "basic";
+        if (entry.flags & ROM_CAT_32K)
+            size = "32K";
+        else if (slot & ROM_SLOT_HALF)
+            size = (slot & ROM_SLOT_UPPER) ? "16K-hi" : "16K-lo";
+        else
+            size = "16K";
+        snprintf(buffer, SCREENW - 3, "%s %s %s %08lX %s", size, mode,
+                 (entry.flags & ROM_CAT_CBM) ? "CBM" : "---", entry.crc,
+                 entry.description);
+    }
+
+    textcolor(COLOR_CYAN);
+    cputsxy(2, 13, buffer);
+    textcolor(COLOR_GRAY3);
+    PROFILE_LEAVE(PROF_DRAW_ROM_DETAILS);
 }
 
 void draw_jiffy_screen(int selected)
 {
+    PROFILE_ENTER(PROF_DRAW_JIFFY_SCREEN);
+    redraw_begin();
     draw_content_area("Toggle JiffyDOS setting:", jiffyOptions, 2, selected);
+    redraw_end();
+    PROFILE_LEAVE(PROF_DRAW_JIFFY_SCREEN);
 }
 
 void draw_content_area(const char *title, const char *options[], int count, int selected)
 {
     unsigned char i;
 
+    PROFILE_ENTER(PROF_DRAW_CONTENT_AREA);
     clear_menu_transition_rows();
 
     // Keep a fixed, framed work area on both the 40- and 80-column displays.
@@ -462,55 +999,63 @@ void draw_content_area(const char *title, const char *options[], int count, int
     draw_main_frame(title);
 
     draw_options_initial(options, count, selected);
-    on_screen_instructions(count == 2);
+    on_screen_instructions(current_screen == 1);
+    PROFILE_LEAVE(PROF_DRAW_CONTENT_AREA);
 }
 
 void on_screen_instructions(const bool isJiffy)
 {
     draw_frame_rule(14);
+    // The empty bank line only applies to the ROM list
+    ui_put_lines(pageHelp, isJiffy ? 3 : 4);
     textcolor(COLOR_GRAY3);
-    cputsxy(2, 15, "UP/DOWN selects    ENTER applies");
-    cputsxy(2, 16, "Saved settings take effect on reset.");
-    textcolor(COLOR_LIGHTGREEN);
-    cputsxy(2, 17, "Hold RESET 3 sec: return to menu.");
-    textcolor(COLOR_GRAY3);
-    if (isJiffy == false) {
-        cputsxy(2, 18, "Empty bank gives a clean C128 state.");
-    }
 }
 
 void draw_options_initial(const char *options[], int count, int selected)
 {
     unsigned char i;
+    unsigned char last;
     (void)options;
 
     /* The menu is always centred in the same visual panel.  Two columns
-     * preserve a useful selection width even on the 40-column VIC display. */
-    for (i = 0; i < count; i++)
+     * preserve a useful selection width even on the 40-column VIC display;
+     * longer lists become a window of LIST_ROWS entries that scrolls. */
+    list_top = (list_is_virtual(count) && selected >= LIST_ROWS)
+                   ? selected - LIST_ROWS + 1
+                   : 0;
+    last = list_is_virtual(count) ? list_top + LIST_ROWS : count;
+    for (i = list_top; i < last; i++)
         draw_option(i, count, i == selected);
+    draw_list_markers(count);
+    list_drawn_selected = selected;
 }
 
 void draw_options_colors(int count, int selected)
 {
-    static int last_selected = -1;
     static int last_screen = -1;
     unsigned char i;
+    unsigned char last;
+    unsigned char scrolled;
 
-    if (last_selected == -1 || last_screen != current_screen)
+    scrolled = list_follow(count, selected);
+    if (list_drawn_selected == -1 || last_screen != current_screen || scrolled > 1)
     {
-        for (i = 0; i < count; i++)
+        last = list_is_virtual(count) ? list_top + LIST_ROWS : count;
+        for (i = list_top; i < last; i++)
             draw_option(i, count, i == selected);
+        draw_list_markers(count);
         last_screen = current_screen;
     }
     else
     {
-        if (last_selected != selected && last_selected < count)
-            draw_option(last_selected, count, 0);
+        // A one-row scroll has already moved the other rows on screen
+        if (list_drawn_selected != selected && list_drawn_selected < count)
+            draw_option(list_drawn_selected, count, 0);
 
         draw_option(selected, count, 1);
     }
 
-    last_selected = selected;
+    list_drawn_selected = selected;
     textcolor(COLOR_GRAY3);
     revers(0);
 }
@@ -523,68 +1068,140 @@ void get_item_position(unsigned char item_index, int total_count, unsigned char
 
     use_two_columns = (total_count > 7);
 
-    if (use_two_columns)
+    if (list_is_virtual(total_count))
+    {
+        // Scrolling single column
+        *x = 1;
+        *y = LIST_TOP + (item_index - list_top);
+    }
+    else if (use_two_columns)
     {
         items_per_column = (total_count + 1) / 2;
 
         if (item_index >= items_per_column)
         {
             // Right column
-            *x = SCREENW / 2 + 1;
-            *y = 5 + (item_index - items_per_column);
+            *x = display->half + 1;
+            *y = LIST_TOP + (item_index - items_per_column);
         }
         else
         {
             // Left column
             *x = 1;
-            *y = 5 + item_index;
+            *y = LIST_TOP + item_index;
         }
     }
     else
     {
         // Single column
         *x = 1;
-        *y = 5 + item_index;
+        *y = LIST_TOP + item_index;
     }
 }
 
 void draw_option(int option_num, int total_count, int is_selected)
 {
+    static unsigned char cells[80];
     const char *label;
     unsigned char line_x, line_y;
     unsigned char column_width;
     unsigned char i;
-    unsigned char label_length;
+    unsigned char reverse;
+    unsigned int offset;
+
+    // Entries outside a scrolling window are not on screen
+    if (list_is_virtual(total_count) &&
+        (option_num < list_top || option_num >= list_top + LIST_ROWS))
+        return;
 
+    PROFILE_ENTER(PROF_DRAW_OPTION);
     get_item_position(option_num, total_count, &line_x, &line_y);
-    column_width = (total_count > 7) ? (SCREENW / 2 - 2) : (SCREENW - 4);
+    column_width = (total_count > 7 && !list_is_virtual(total_count))
+                       ? (display->half - 2)
+                       : (SCREENW - 4);
 
     if (current_screen == 0)
-        label = romNames[option_num];
+        label = romNames[rom_view[option_num]];
     else
         label = jiffyOptions[option_num];
 
-    label_length = strlen(label);
-    gotoxy(line_x, line_y);
+    // Build the whole row as screen codes and write it in one span
+    reverse = is_selected ? DISPLAY_REVERSE : 0;
+    cells[0] = (is_selected ? '>' : DISPLAY_SPACE) | reverse;
+    cells[1] = DISPLAY_SPACE | reverse;
+    for (i = 2; i < column_width && *label; i++)
+        cells[i] = display_screen_code(*label++) | reverse;
+    for (; i < column_width; i++)
+        cells[i] = DISPLAY_SPACE | reverse;
+
+    offset = display->row_offset[line_y] + line_x;
+    display->put_span(offset, cells, column_width);
+    display->set_colour(offset, COLOR_GRAY3, column_width);
+    PROFILE_LEAVE(PROF_DRAW_OPTION);
+}
+
+bool list_is_virtual(int count)
+{
+    return count > 2 * LIST_ROWS;
+}
+
+/* Moves the scrolling window so 'selected' is visible. Returns 0 if the
+ * window stayed put, 1 if it moved by one row (the panel is shifted on
+ * screen and only the exposed row needs drawing) or 2 if it jumped and the
+ * whole window must be redrawn. */
+unsigned char list_follow(int count, int selected)
+{
+    unsigned char top = list_top;
 
-    if (is_selected)
+    if (!list_is_virtual(count))
     {
-        textcolor(COLOR_GRAY3);
-        revers(1);
+        list_top = 0;
+        return 0;
     }
-    else
+
+    if (selected < top)
+        top = selected;
+    else if (selected >= top + LIST_ROWS)
+        top = selected - LIST_ROWS + 1;
+
+    if (top == list_top)
+        return 0;
+
+    if (top == list_top + 1 || top + 1 == list_top)
     {
-        textcolor(COLOR_GRAY3);
-        revers(0);
+        scroll_list_rows(top > list_top);
+        list_top = top;
+        draw_list_markers(count);
+        return 1;
     }
 
-    cputc(is_selected ? '>' : ' ');
-    cputc(' ');
-    cputs(label);
-    for (i = label_length + 2; i < column_width; i++)
-        cputc(' ');
+    list_top = top;
+    return 2;
+}
+
+/* Shifts the list rows one line up or down in screen memory. The marker
+ * cells are blanked first, or the move would carry the arrows into the
+ * middle of the list where draw_list_markers() never clears them. */
+void scroll_list_rows(bool up)
+{
+    display->fill(display->row_offset[LIST_TOP] + SCREENW - 3,
+                  DISPLAY_SPACE, 1);
+    display->fill(display->row_offset[LIST_TOP + LIST_ROWS - 1] + SCREENW - 3,
+                  DISPLAY_SPACE, 1);
+    display->move_rows(LIST_TOP, LIST_ROWS, up);
+}
+
+// Arrows at the right edge of the window when more entries are hidden
+void draw_list_markers(int count)
+{
+    if (!list_is_virtual(count))
+        return;
 
     revers(0);
+    textcolor(COLOR_LIGHTBLUE);
+    cputcxy(SCREENW - 3, LIST_TOP, list_top > 0 ? '^' : ' ');
+    cputcxy(SCREENW - 3, LIST_TOP + LIST_ROWS - 1,
+            list_top + LIST_ROWS < count ? 'v' : ' ');
     textcolor(COLOR_GRAY3);
 }
 
@@ -608,6 +1225,8 @@ void draw_info_screen(void)
 {
     unsigned char i;
 
+    PROFILE_ENTER(PROF_DRAW_INFO_SCREEN);
+    redraw_begin();
     clear_menu_transition_rows();
 
     for (i = 3; i <= 20; i++)
@@ -616,74 +1235,79 @@ void draw_info_screen(void)
     }
 
     draw_main_frame("ABOUT ULTRA-36");
-    textcolor(COLOR_WHITE);
-    cputsxy(2, 5, "ROM switcher for Commodore 128");
-    cputsxy(2, 6, "Version ");
+    ui_put_lines(infoAbout, 6);
     cputsxy(10, 6, APP_VERSION);
-    cputsxy(2, 8, "* 8 or 16 switchable ROM banks");
-    cputsxy(2, 9, "* JiffyDOS setting stored in flash");
-    cputsxy(2, 10, "* VIC-II 40 and VDC 80 columns");
-    cputsxy(2, 12, "Selection is remembered by Ultra-36.");
+    if (warm_state.ack_steps != WARM_ACK_UNKNOWN)
+    {
+        char buffer[40];
+        sprintf(buffer, "Last acknowledge: %u polls", warm_state.ack_steps);
+        textcolor(COLOR_GRAY3);
+        cputsxy(2, 13, buffer);
+    }
     draw_frame_rule(14);
+    ui_put_lines(infoKeys, 4);
     textcolor(COLOR_GRAY3);
-    cputsxy(2, 15, "F1-F3: sections    F4-F7: tools");
-    cputsxy(2, 16, "UP/DOWN: move      ENTER: apply");
-    textcolor(COLOR_LIGHTGREEN);
-    cputsxy(2, 18, "RESET 3 sec returns to this menu.");
-    textcolor(COLOR_GRAY3);
+    redraw_end();
+    PROFILE_LEAVE(PROF_DRAW_INFO_SCREEN);
+}
+
+// Re-run the boot-time image check on demand, as a 2 MHz burst
+void verify_menu_image(void)
+{
+    unsigned char result;
+
+    redraw_begin();
+    result = rom_self_check();
+    redraw_end();
+
+    if (result == ROM_CHECK_OK)
+    {
+        show_status_message("Menu ROM image OK.", COLOR_LIGHTGREEN, 2);
+    }
+    else if (result == ROM_CHECK_LOWER)
+    {
+        show_status_message("ERROR: Menu ROM damaged at $8000-$BFFF.", COLOR_LIGHTRED, 3);
+    }
+    else
+    {
+        show_status_message("ERROR: Menu ROM damaged at $C000-$FEFB.", COLOR_LIGHTRED, 3);
+    }
 }
 
 void draw_util_bar(void)
 {
+    const struct util_key *key;
+    unsigned char i;
+
     fill_line(22, COLOR_LIGHTBLUE, 0);
     fill_line(23, COLOR_BLUE, 0);
     fill_line(24, COLOR_BLUE, 0);
 
     // Bottom shortcuts deliberately use the same compact key-cap treatment
     // as the menu strip, leaving enough room for VIC 40 columns.
-    gotoxy(1, 23);
-    revers(1);
-    textcolor(COLOR_GRAY3);
-    cputs(" F4 ");
-    revers(0);
-    textcolor(COLOR_CYAN);
-    cputs(" C64");
-
-    gotoxy(SCREENW / 2 + 1, 23);
-    revers(1);
-    textcolor(COLOR_GRAY3);
-    cputs(" F5 ");
-    revers(0);
-    textcolor(COLOR_CYAN);
-    cputs(" Restart");
-
-    gotoxy(1, 24);
-    revers(1);
-    textcolor(COLOR_GRAY3);
-    cputs(" F6 ");
-    revers(0);
-    textcolor(COLOR_CYAN);
-    cputs(" VDC Info");
-
-    gotoxy(SCREENW / 2 + 1, 24);
-    revers(1);
-    textcolor(COLOR_GRAY3);
-    cputs(" F7 ");
-    revers(0);
-    textcolor(COLOR_CYAN);
-    cputs(" SID Info");
+    for (i = 0; i < UTIL_KEY_COUNT; i++)
+    {
+        key = &utilKeys[i];
+        gotoxy(key->right ? display->half + 1 : 1, key->y);
+        revers(1);
+        textcolor(COLOR_GRAY3);
+        cputs(key->cap);
+        revers(0);
+        textcolor(COLOR_CYAN);
+        cputs(key->label);
+    }
     textcolor(COLOR_GRAY3);
 }
 
+// Two block fills instead of a conio character round trip per column
 void fill_line(unsigned char y, unsigned char color, unsigned char reversed)
 {
-    unsigned char i;
+    unsigned int offset = display->row_offset[y];
 
-    gotoxy(0, y);
+    display->fill(offset, reversed ? DISPLAY_SPACE | DISPLAY_REVERSE
+                                   : DISPLAY_SPACE, SCREENW);
+    display->set_colour(offset, color, SCREENW);
     textcolor(color);
-    revers(reversed);
-    for (i = 0; i < SCREENW; i++)
-        cputc(' ');
     revers(0);
 }
 
@@ -727,6 +1351,8 @@ void draw_main_frame(const char *title)
     textcolor(COLOR_GRAY3);
 }
 
+/* Shows 'message' on row 21 and returns at once. The status task clears it
+ * after 'seconds'; 0 keeps it until the next message replaces it. */
 void show_status_message(const char *message, unsigned char color,
                          unsigned char seconds)
 {
@@ -734,6 +1360,9 @@ void show_status_message(const char *message, unsigned char color,
     textcolor(color);
     cputsxy(1, 21, message);
     textcolor(COLOR_GRAY3);
-    sleep(seconds);
-    fill_line(21, COLOR_BLUE, 0);
+    status_seconds = seconds;
+    if (seconds != 0)
+        task_start(TASK_STATUS);
+    else
+        task_stop(TASK_STATUS);
 }
@@ -0,0 +1,185 @@
+//   _____  ___________              _______________
+//   __  / / /__  /_  /_____________ __|__  /_  ___/
+//   _  / / /__  /_  __/_  ___/  __ `/__/_ <_  __ \
+//   / /_/ / _  / / /_ _  /   / /_/ /____/ // /_/ /
+//   \____/  /_/  \__/ /_/    \__,_/ /____/ \____/
+// Ultra-36 Rom Switcher for Commodore 128 - C128 Menu Program
+// Free for personal use.
+// Commercial use or resale (in whole or part) prohibited without permission.
+// (c) 2025 Lukasz Dziwosz / LukasSoft. All Rights Reserved.
+
+#include <stdio.h>
+#include <string.h>
+#include "name_table.h"
+#include "high_rom.h"
+
+#ifdef ONLINE_BUILD
+#include "online_rom_config.h"
+#endif
+
+#ifndef USER_ROM_NAMES_INIT
+#error USER_ROM_NAMES_INIT must define the 6, 14, 30 or 62 user-selectable ROM names
+#endif
+
+#ifndef NUM_USER_ROMS
+#error NUM_USER_ROMS must be set to 6, 14, 30 or 62
+#endif
+
+// Banks above 15 and packed halves are selected with the $C0/$E0 latch
+// prefixes, which only the latch firmware understands
+#ifndef LINK_LATCHES
+#if NUM_USER_ROMS > 14 || defined(USER_ROM_SLOTS_INIT)
+#error More than 16 banks or a packed image need LINK_LATCHES=1 and the latch firmware
+#endif
+#endif
+
+// Packed images (ultra36-flash -p) list each ROM's bank and half; otherwise
+// every ROM owns a whole bank and the count must match a flash layout
+#ifdef USER_ROM_SLOTS_INIT
+#if NUM_USER_ROMS < 1 || NUM_USER_ROMS > NAME_TABLE_MAX_NAMES
+#error NUM_USER_ROMS must be 1 to 62 for a packed image
+#endif
+#else
+#define USER_ROM_SLOTS_INIT 0
+#if !NAME_TABLE_LAYOUT_COUNT(NUM_USER_ROMS)
+#error NUM_USER_ROMS must be exactly 6, 14, 30 or 62 (8, 16, 32 or 64 banks)
+#endif
+#endif
+
+/*
+ * The build-time names only seed the table. "make" generates the search
+ * index and seals the checksum after linking; scripts/rom_patch.py can later
+ * replace names and count in place.
+ */
+#pragma rodata-name (push, "NAMETABLE")
+const struct name_table rom_name_table = {
+    {NAME_TABLE_MAGIC0, NAME_TABLE_MAGIC1, NAME_TABLE_MAGIC2, NAME_TABLE_MAGIC3},
+    NAME_TABLE_VERSION,
+    NUM_USER_ROMS,
+    0,
+    {USER_ROM_NAMES_INIT},
+    {0},
+    {0},
+    {USER_ROM_SLOTS_INIT}
+};
+#pragma rodata-name (pop)
+
+static struct name_table name_table;
+
+static unsigned char name_table_valid(void)
+{
+    const unsigned char *byte;
+    unsigned int sum = 0;
+
+    if (name_table.magic[0] != NAME_TABLE_MAGIC0 ||
+        name_table.magic[1] != NAME_TABLE_MAGIC1 ||
+        name_table.magic[2] != NAME_TABLE_MAGIC2 ||
+        name_table.magic[3] != NAME_TABLE_MAGIC3 ||
+        name_table.version != NAME_TABLE_VERSION ||
+        name_table.count == 0 ||
+        name_table.count > NAME_TABLE_MAX_NAMES)
+        return 0;
+
+    sum = name_table.version + name_table.count;
+    for (byte = (const unsigned char *)name_table.names;
+         byte != (const unsigned char *)(&name_table + 1);
+         ++byte)
+        sum += *byte;
+    return sum == name_table.checksum;
+}
+
+unsigned char load_rom_names(const char *names[])
+{
+    unsigned char i;
+
+    /*
+     * Bank 0 contains this menu program. Bank 1 must always be the empty
+     * bank, so its label is a firmware invariant rather than table content.
+     */
+    names[0] = "Empty_Bank";
+
+    high_rom_copy(&name_table, &rom_name_table, sizeof(name_table));
+    if (!name_table_valid())
+    {
+        name_table.count = NUM_USER_ROMS;
+        for (i = 0; i < NUM_USER_ROMS; i++)
+            sprintf(name_table.names[i], "Bank %u", i + 2);
+        // Without a trusted index every first-letter run is empty
+        memset(name_table.first, 0, sizeof(name_table.first));
+        memset(name_table.slots, 0, sizeof(name_table.slots));
+    }
+
+    for (i = 0; i < name_table.count; i++)
+    {
+        name_table.names[i][NAME_TABLE_NAME_SIZE - 1] = '\0';
+        names[i + 1] = name_table.names[i];
+    }
+    return name_table.count + 1;
+}
+
+// Letters compare equal in either case: PETSCII $41-$5A and $C1-$DA
+static unsigned char fold(unsigned char c)
+{
+    if ((c & 0x7F) >= 0x41 && (c & 0x7F) <= 0x5A)
+        return c & 0x7F;
+    return c;
+}
+
+unsigned char match_rom_names(const char *prefix, unsigned char length,
+                              unsigned char *first)
+{
+    unsigned char key;
+    unsigned char start;
+    unsigned char count;
+    unsigned char matched;
+    unsigned char pos;
+    unsigned char c;
+
+    if (length == 0 || length >= NAME_TABLE_NAME_SIZE)
+        return 0;
+
+    // One table lookup finds the run of labels with the same first key
+    c = fold(prefix[0]);
+    key = (c >= 0x41 && c <= 0x5A) ? c - 0x40 : 0;
+    start = name_table.first[key];
+    if (name_table.first[key + 1] < start ||
+        name_table.first[key + 1] > name_table.count)
+        return 0;
+    count = name_table.first[key + 1] - start;
+
+    /* The run agrees on the characters before 'pos', so character 'pos' is
+     * sorted: skip the smaller ones, then keep the equal ones. */
+    for (pos = 0; pos < length && count != 0; pos++)
+    {
+        c = fold(prefix[pos]);
+        while (count != 0 &&
+               fold(name_table.names[name_table.order[start]][pos]) < c)
+        {
+            start++;
+            count--;
+        }
+        for (matched = 0; matched < count; matched++)
+        {
+            if (fold(name_table.names[name_table.order[start + matched]][pos]) != c)
+                break;
+        }
+        count = matched;
+    }
+
+    *first = start;
+    return count;
+}
+
+unsigned char sorted_rom_name(unsigned char position)
+{
+    return name_table.order[position] + 1;
+}
+
+unsigned char rom_slot(unsigned char entry)
+{
+    if (entry == 0)
+        return 1;
+    if (name_table.slots[entry - 1] != 0)
+        return name_table.slots[entry - 1];
+    return entry + 1;
+}
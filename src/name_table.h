@@ -0,0 +1,64 @@
+#ifndef NAME_TABLE_H
+#define NAME_TABLE_H
+
+/*
+ * Fixed-layout bank label table. The linker places it at the start of the
+ * upper ROM ($C000, file offset $4000) in the 32K build and at $BB00 (file
+ * offset $3B00) in the 16K build, so scripts/rom_patch.py can rewrite the
+ * labels of a prebuilt menu ROM without recompiling it. The sorted
+ * first-letter index behind type-to-filter search is generated by the same
+ * script, both after "make" links the ROM and whenever it patches names.
+ */
+#define NAME_TABLE_MAGIC0       'U'
+#define NAME_TABLE_MAGIC1       '3'
+#define NAME_TABLE_MAGIC2       '6'
+#define NAME_TABLE_MAGIC3       'N'
+#define NAME_TABLE_VERSION      4
+#define NAME_TABLE_MAX_NAMES    62      // 64 banks of a 2MB flash part
+#define NAME_TABLE_NAME_SIZE    17      // 16 PETSCII characters + NUL
+#define NAME_TABLE_KEYS         27      // 0: not a letter, 1-26: A-Z
+
+struct name_table {
+    char magic[4];
+    unsigned char version;
+    unsigned char count;                // User ROMs: 1-62
+    unsigned int checksum;              // 16-bit sum of version..slots
+    char names[NAME_TABLE_MAX_NAMES][NAME_TABLE_NAME_SIZE];
+    // Name numbers sorted by label (letters ignore case), grouped by the
+    // key of the first character; key k owns order[first[k]..first[k+1]-1]
+    unsigned char order[NAME_TABLE_MAX_NAMES];
+    unsigned char first[NAME_TABLE_KEYS + 1];
+    // Bank and half of each name (ROM_SLOT_*), 0 for bank n + 2 as a whole
+    unsigned char slots[NAME_TABLE_MAX_NAMES];
+};
+
+// Name table slot: flash bank plus the 16K half two packed ROMs share
+#define ROM_SLOT_BANK   0x3F
+#define ROM_SLOT_HALF   0xC0
+#define ROM_SLOT_LOWER  0x40
+#define ROM_SLOT_UPPER  0x80
+
+// User ROM counts of the unpacked 8, 16, 32 and 64 bank flash layouts
+#define NAME_TABLE_LAYOUT_COUNT(count) \
+    ((count) == 6 || (count) == 14 || (count) == 30 || (count) == 62)
+
+// Highest selectable bank count: Empty_Bank plus every user ROM
+#define MAX_ROMS (NAME_TABLE_MAX_NAMES + 1)
+
+// Fills names[] with Empty_Bank and the user ROM labels from the table,
+// or "Bank N" labels if the table is damaged. Returns the entry count.
+unsigned char load_rom_names(const char *names[]);
+
+// Finds the user ROMs whose label starts with prefix[0..length-1], letters
+// matching either case. Returns the number of matches, which are
+// sorted_rom_name(*first) onwards. A damaged table never matches.
+unsigned char match_rom_names(const char *prefix, unsigned char length,
+                              unsigned char *first);
+
+// names[] index of the label at 'position' in sorted order
+unsigned char sorted_rom_name(unsigned char position);
+
+// ROM_SLOT_* bank and half behind names[entry] (0 = Empty_Bank)
+unsigned char rom_slot(unsigned char entry);
+
+#endif
@@ -0,0 +1,168 @@
+//   _____  ___________              _______________
+//   __  / / /__  /_  /_____________ __|__  /_  ___/
+//   _  / / /__  /_  __/_  ___/  __ `/__/_ <_  __ \
+//   / /_/ / _  / / /_ _  /   / /_/ /____/ // /_/ /
+//   \____/  /_/  \__/ /_/    \__,_/ /____/ \____/
+// Ultra-36 Rom Switcher for Commodore 128 - C128 Menu Program - profile.c
+// Free for personal use.
+// Commercial use or resale (in whole or part) prohibited without permission.
+// (c) 2025 Lukasz Dziwosz / LukasSoft. All Rights Reserved.
+
+#ifdef PROFILE
+
+#include <conio.h>
+#include <c128.h>
+#include <string.h>
+#include "profile.h"
+#include "cycle_timer.h"
+#include "stack_usage.h"
+#include "scheduler.h"
+
+#define PROFILE_DEPTH       8
+#define PROFILE_FIRST_ROW   5
+
+struct profile_slot {
+    unsigned int calls;
+    unsigned long total;
+    unsigned long max;
+};
+
+static struct profile_slot profile_table[PROFILE_SLOTS];
+
+// Open slots, innermost last. Deeper nesting is counted but not timed.
+static unsigned char profile_depth;
+static unsigned char profile_open[PROFILE_DEPTH];
+static unsigned long profile_start[PROFILE_DEPTH];
+
+// Cycles of an empty enter/leave pair, taken off every sample
+static unsigned long profile_overhead;
+
+static const char * const profile_names[PROFILE_SLOTS] = {
+    "dispatch", "rom_screen", "jiffy_scr", "info_scr", "content",
+    "rom_list", "rom_detail", "option", "send_cmd", "sid1_detect",
+    "vdc_screen", "sid_screen"
+};
+
+void profile_init(void)
+{
+    cycle_timer_run();
+    profile_overhead = 0;
+    profile_enter(PROF_DISPATCH);
+    profile_leave(PROF_DISPATCH);
+    profile_overhead = profile_table[PROF_DISPATCH].total;
+    memset(profile_table, 0, sizeof(profile_table));
+}
+
+void __fastcall__ profile_enter(unsigned char slot)
+{
+    if (profile_depth < PROFILE_DEPTH) {
+        profile_open[profile_depth] = slot;
+        profile_start[profile_depth] = cycle_timer_read();
+    }
+    ++profile_depth;
+}
+
+void __fastcall__ profile_leave(unsigned char slot)
+{
+    unsigned long cycles = cycle_timer_read();
+    struct profile_slot *entry;
+
+    // A leave without its enter (the first pass of the menu loop) is ignored
+    if (profile_depth == 0)
+        return;
+    if (profile_depth > PROFILE_DEPTH) {
+        --profile_depth;
+        return;
+    }
+    if (profile_open[profile_depth - 1] != slot)
+        return;
+    --profile_depth;
+
+    cycles -= profile_start[profile_depth];
+    cycles = cycles > profile_overhead ? cycles - profile_overhead : 0;
+    entry = &profile_table[slot];
+    ++entry->calls;
+    entry->total += cycles;
+    if (cycles > entry->max)
+        entry->max = cycles;
+}
+
+static void draw_profile_table(void)
+{
+    unsigned char i;
+
+    for (i = 0; i < PROFILE_SLOTS; ++i) {
+        gotoxy(0, PROFILE_FIRST_ROW + i);
+        cprintf("%-11s %5u %10lu %9lu", profile_names[i],
+                profile_table[i].calls, profile_table[i].total,
+                profile_table[i].max);
+    }
+}
+
+// High-water marks since the last reset, from the painted stacks
+static void draw_stack_usage(void)
+{
+    gotoxy(0, 22);
+    cprintf("Stack unused: C %u of %u, CPU %u  ", stack_c_free(),
+            stack_c_size, stack_cpu_free());
+}
+
+// Task runs that took longer than their budget, in TASK_* order
+static void draw_task_overruns(void)
+{
+    unsigned char i;
+
+    gotoxy(0, 23);
+    cputs("Overruns:");
+    for (i = 0; i < TASK_COUNT; ++i)
+        cprintf(" %u", tasks[i].overruns);
+    cclear(4);
+}
+
+void draw_profile_screen(unsigned char screen_width)
+{
+    unsigned char i;
+    unsigned char key;
+
+    for (i = 1; i < 25; ++i)
+        cclearxy(0, i, screen_width);
+
+    gotoxy(0, 1);
+    revers(1);
+    textcolor(COLOR_LIGHTRED);
+    for (i = 0; i < screen_width; ++i)
+        cputc(' ');
+    cputsxy(0, 1, "Profile");
+    gotoxy(screen_width - 8, 1);
+    cputs("F8: Exit");
+    revers(0);
+
+    textcolor(COLOR_WHITE);
+    gotoxy(0, 3);
+    cprintf("CIA2 cycles, %lu per sample removed", profile_overhead);
+    textcolor(COLOR_CYAN);
+    cputsxy(0, 4, "routine     calls      total       max");
+    textcolor(COLOR_WHITE);
+    draw_profile_table();
+    draw_stack_usage();
+    draw_task_overruns();
+    textcolor(COLOR_GRAY3);
+    cputsxy(0, 18, "Totals include nested routines.");
+    cputsxy(0, 20, "R        Reset counters");
+
+    while (1) {
+        key = cgetc();
+        if (key == 'r' || key == 'R') {
+            memset(profile_table, 0, sizeof(profile_table));
+            for (i = 0; i < TASK_COUNT; ++i)
+                tasks[i].overruns = 0;
+            textcolor(COLOR_WHITE);
+            draw_profile_table();
+            draw_task_overruns();
+        } else if (key == CH_F8) {
+            break;
+        }
+    }
+}
+
+#endif
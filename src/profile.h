@@ -0,0 +1,44 @@
+#ifndef PROFILE_H
+#define PROFILE_H
+
+/*
+ * Cycle profiler for "make PROFILE=1" builds. PROFILE_ENTER/PROFILE_LEAVE
+ * pairs time the enclosed code on the CIA2 cycle counter (cycle_timer.h)
+ * and collect calls, total and maximum cycles per slot. Times include
+ * nested slots. CTRL-P in the menu shows the table. In normal builds the
+ * macros expand to nothing.
+ */
+#define PROF_DISPATCH           0       // One key press handled by input_task()
+#define PROF_DRAW_ROM_SCREEN    1
+#define PROF_DRAW_JIFFY_SCREEN  2
+#define PROF_DRAW_INFO_SCREEN   3
+#define PROF_DRAW_CONTENT_AREA  4
+#define PROF_DRAW_ROM_LIST      5
+#define PROF_DRAW_ROM_DETAILS   6
+#define PROF_DRAW_OPTION        7
+#define PROF_SEND_COMMAND       8
+#define PROF_DETECT_SID1        9
+#define PROF_DRAW_VDC_INFO      10
+#define PROF_DRAW_SID_INFO      11
+#define PROFILE_SLOTS           12
+
+#define CH_PROFILE              0x10    // CTRL-P
+
+#ifdef PROFILE
+
+void profile_init(void);
+void __fastcall__ profile_enter(unsigned char slot);
+void __fastcall__ profile_leave(unsigned char slot);
+void draw_profile_screen(unsigned char screen_width);
+
+#define PROFILE_ENTER(slot)     profile_enter(slot)
+#define PROFILE_LEAVE(slot)     profile_leave(slot)
+
+#else
+
+#define PROFILE_ENTER(slot)
+#define PROFILE_LEAVE(slot)
+
+#endif
+
+#endif
@@ -0,0 +1,79 @@
+//   _____  ___________              _______________
+//   __  / / /__  /_  /_____________ __|__  /_  ___/
+//   _  / / /__  /_  __/_  ___/  __ `/__/_ <_  __ \
+//   / /_/ / _  / / /_ _  /   / /_/ /____/ // /_/ /
+//   \____/  /_/  \__/ /_/    \__,_/ /____/ \____/
+// Ultra-36 Rom Switcher for Commodore 128 - C128 Menu Program - redraw.c
+// Free for personal use.
+// Commercial use or resale (in whole or part) prohibited without permission.
+// (c) 2025 Lukasz Dziwosz / LukasSoft. All Rights Reserved.
+
+#include <c128.h>
+#include <peekpoke.h>
+#include "redraw.h"
+
+#define VIC_CTRL1           0xD011
+#define VIC_RASTER          0xD012
+#define VIC_CTRL1_RST8      0x80    // Raster line bit 8
+#define VIC_CTRL1_DEN       0x10    // Display enable
+#define VIC_BORDER_LINE     0xFB    // First line of the lower border
+
+static unsigned char redraw_vic;
+static unsigned char redraw_depth;
+static unsigned char redraw_paused;
+
+void __fastcall__ redraw_init(unsigned char vic_active)
+{
+    redraw_vic = vic_active;
+    redraw_depth = 0;
+    redraw_paused = 0;
+}
+
+// Wait until the raster is below the text area (line 251 up to the wrap)
+static void wait_lower_border(void)
+{
+    while (!(PEEK(VIC_CTRL1) & VIC_CTRL1_RST8) &&
+           PEEK(VIC_RASTER) < VIC_BORDER_LINE) {}
+}
+
+static void burst_on(void)
+{
+    wait_lower_border();
+    POKE(VIC_CTRL1, PEEK(VIC_CTRL1) & (unsigned char)~VIC_CTRL1_DEN);
+    fast();
+}
+
+static void burst_off(void)
+{
+    slow();
+    wait_lower_border();
+    POKE(VIC_CTRL1, PEEK(VIC_CTRL1) | VIC_CTRL1_DEN);
+}
+
+void redraw_begin(void)
+{
+    if (!redraw_vic)
+        return;
+    if (redraw_depth++ == 0 && !redraw_paused)
+        burst_on();
+}
+
+void redraw_end(void)
+{
+    if (!redraw_vic || redraw_depth == 0)
+        return;
+    if (--redraw_depth == 0 && !redraw_paused)
+        burst_off();
+}
+
+void redraw_pause(void)
+{
+    if (redraw_depth != 0 && redraw_paused++ == 0)
+        burst_off();
+}
+
+void redraw_resume(void)
+{
+    if (redraw_paused != 0 && --redraw_paused == 0 && redraw_depth != 0)
+        burst_on();
+}
@@ -0,0 +1,21 @@
+#ifndef REDRAW_H
+#define REDRAW_H
+
+/*
+ * 2 MHz bursts for 40-column repaints. The VIC-II cannot fetch at 2 MHz,
+ * so redraw_begin() waits for the lower border, blanks the display through
+ * $D011 and switches to FAST; redraw_end() drops back to 1 MHz and unblanks
+ * in the next lower border. Bursts nest, and do nothing on the VDC, which
+ * already runs at 2 MHz.
+ *
+ * Code that is timed by CPU loops (the Ultra-36 serial protocol) brackets
+ * itself with redraw_pause()/redraw_resume(), which run it at 1 MHz with
+ * the display on even when called from inside a burst.
+ */
+void __fastcall__ redraw_init(unsigned char vic_active);
+void redraw_begin(void);
+void redraw_end(void);
+void redraw_pause(void);
+void redraw_resume(void);
+
+#endif
@@ -0,0 +1,52 @@
+//   _____  ___________              _______________
+//   __  / / /__  /_  /_____________ __|__  /_  ___/
+//   _  / / /__  /_  __/_  ___/  __ `/__/_ <_  __ \
+//   / /_/ / _  / / /_ _  /   / /_/ /____/ // /_/ /
+//   \____/  /_/  \__/ /_/    \__,_/ /____/ \____/
+// Ultra-36 Rom Switcher for Commodore 128 - C128 Menu Program
+// Free for personal use.
+// Commercial use or resale (in whole or part) prohibited without permission.
+// (c) 2025 Lukasz Dziwosz / LukasSoft. All Rights Reserved.
+
+#include "rom_catalog.h"
+#include "high_rom.h"
+
+#ifdef ROM_CATALOG
+#include "rom_catalog_data.h"
+
+#ifdef ONLINE_BUILD
+#include "online_rom_config.h"
+#endif
+
+#if defined(NUM_USER_ROMS) && ROM_CATALOG_COUNT != NUM_USER_ROMS + 1
+#error rom_catalog_data.h was generated for a different bank count
+#endif
+
+// Generated by "make flash" from the real bank images. It lives in the upper
+// 16K so it costs nothing in the crowded lower ROM half.
+#pragma rodata-name (push, "HIRODATA")
+static const struct rom_catalog_entry rom_catalog[ROM_CATALOG_COUNT] = {
+    ROM_CATALOG_INIT
+};
+#pragma rodata-name (pop)
+
+unsigned char __fastcall__ rom_catalog_read(unsigned char index,
+                                            struct rom_catalog_entry *entry)
+{
+    if (index >= ROM_CATALOG_COUNT)
+        return 0;
+    high_rom_copy(entry, &rom_catalog[index], sizeof(*entry));
+    return 1;
+}
+
+#else
+
+unsigned char __fastcall__ rom_catalog_read(unsigned char index,
+                                            struct rom_catalog_entry *entry)
+{
+    (void)index;
+    (void)entry;
+    return 0;
+}
+
+#endif
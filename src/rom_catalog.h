@@ -0,0 +1,24 @@
+#ifndef ROM_CATALOG_H
+#define ROM_CATALOG_H
+
+// Per-bank catalog flags written by tools/ultra36_flash.c (-C)
+#define ROM_CAT_32K     0x01    // Image fills the whole 32K bank
+#define ROM_CAT_CBM     0x02    // "CBM" signature present at $8007
+#define ROM_CAT_HALF    0x04    // Packed into half a bank; CRC of the 16K
+#define ROM_CAT_EMPTY   0x80    // Generated Empty_Bank, no image
+
+#define ROM_CAT_DESCRIPTION_LENGTH 16
+
+struct rom_catalog_entry {
+    unsigned char flags;
+    unsigned char cart_mode;        // Autostart byte at $8006
+    unsigned long crc;              // CRC-32 of the padded 32K bank
+    char description[ROM_CAT_DESCRIPTION_LENGTH + 1];
+};
+
+// Copies catalog entry 'index' (0 = bank 1) out of the upper ROM.
+// Returns 0 when the menu was built without a catalog.
+unsigned char __fastcall__ rom_catalog_read(unsigned char index,
+                                            struct rom_catalog_entry *entry);
+
+#endif
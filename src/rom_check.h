@@ -0,0 +1,16 @@
+#ifndef ROM_CHECK_H
+#define ROM_CHECK_H
+
+// rom_self_check() results; a failing check at boot halts with the code as
+// border colour
+#define ROM_CHECK_OK        0
+#define ROM_CHECK_LOWER     2   // Red: $8000-$BFFF damaged
+#define ROM_CHECK_UPPER     8   // Orange: $C000-$FEFB damaged (32K build)
+
+// CRC-16/CCITT of length bytes (src/rom_crc.s)
+unsigned int __fastcall__ rom_crc(const void *start, unsigned int length);
+
+// Compare the menu image against the CRCs rom_patch.py sealed into it
+unsigned char rom_self_check(void);
+
+#endif
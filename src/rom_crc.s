@@ -0,0 +1,187 @@
+;
+; Ultra-36 Rom Switcher for Commodore 128 - C128 Menu Program - rom_crc.s
+; CRC-16/CCITT (polynomial $1021, initial value $FFFF) over a block of
+; memory, used to verify the menu image against the value rom_patch.py
+; sealed into it.
+;
+; (c) 2025 Lukasz Dziwosz / LukasSoft. All Rights Reserved.
+;
+
+    .export     _rom_crc
+    .import     popax
+    .importzp   ptr1, ptr2, tmp1, tmp3, tmp4
+
+CRC_CHUNK = 16                  ; Bytes per pass of the unrolled block
+
+; ------------------------------------------------------------------------
+; unsigned int __fastcall__ rom_crc(const void *start, unsigned int length)
+; The block folds CRC_CHUNK bytes per pass with fixed offsets, so no byte
+; pays for an index increment or a branch. The CRC lives in registers, the
+; high byte in A and the low byte in X, and Y doubles as offset and table
+; index: 19 cycles a byte, plus under 2 for advancing ptr1 after each
+; chunk (page-crossing table reads add up to 1 more). A length that is not a whole number of chunks enters the
+; block part-way, with ptr1 moved back to match.
+
+.code
+
+_rom_crc:
+        sta     tmp3            ; Length
+        stx     tmp4
+        jsr     popax
+        sta     ptr1
+        stx     ptr1+1
+
+        lda     #0              ; tmp1 = bytes skipped at the block entry
+        sec
+        sbc     tmp3
+        and     #CRC_CHUNK-1
+        sta     tmp1
+        beq     @entry
+        lda     ptr1            ; ptr1 = start - skipped
+        sec
+        sbc     tmp1
+        sta     ptr1
+        bcs     :+
+        dec     ptr1+1
+:       lda     tmp1            ; Length += skipped, a whole number of chunks
+        clc
+        adc     tmp3
+        sta     tmp3
+        bcc     @entry
+        inc     tmp4
+
+@entry: lda     tmp1            ; ptr2 = crc_block + skipped * 12
+        asl     a
+        asl     a
+        sta     ptr2
+        asl     a
+        adc     ptr2
+        adc     #<crc_block
+        sta     ptr2
+        lda     #>crc_block
+        adc     #0
+        sta     ptr2+1
+
+        ldx     #4              ; Chunks = length / CRC_CHUNK
+:       lsr     tmp4
+        ror     tmp3
+        dex
+        bne     :-
+        lda     tmp3            ; Count tmp4 as passes of 256, starting
+        beq     :+              ; with a partial one if tmp3 is not 0
+        inc     tmp4
+:       lda     tmp4
+        beq     @empty
+
+        lda     #$FF            ; Initial CRC
+        tax
+        jmp     (ptr2)
+
+@empty: lda     #$FF
+        tax
+        rts
+
+; Fold ptr1[0..CRC_CHUNK-1] into the CRC in A (high) and X (low). Each byte
+; is 12 bytes of code, which the entry point calculation above relies on.
+
+crc_block:
+        .repeat CRC_CHUNK, I
+        ldy     #I
+        eor     (ptr1),y
+        tay
+        txa
+        eor     crc_table_hi,y
+        ldx     crc_table_lo,y
+        .endrep
+
+        tay                     ; ptr1 += CRC_CHUNK, CRC high byte kept in Y
+        lda     ptr1
+        clc
+        adc     #CRC_CHUNK
+        sta     ptr1
+        bcc     :+
+        inc     ptr1+1
+:       tya
+        dec     tmp3
+        bne     :+
+        dec     tmp4
+        beq     @done
+:       jmp     crc_block
+
+@done:  stx     tmp1            ; Return the CRC in A/X
+        tax
+        lda     tmp1
+        rts
+
+; ------------------------------------------------------------------------
+; CRC of each byte value shifted through the polynomial, split in halves.
+
+.rodata
+
+crc_table_lo:
+        .byte   $00, $21, $42, $63, $84, $A5, $C6, $E7
+        .byte   $08, $29, $4A, $6B, $8C, $AD, $CE, $EF
+        .byte   $31, $10, $73, $52, $B5, $94, $F7, $D6
+        .byte   $39, $18, $7B, $5A, $BD, $9C, $FF, $DE
+        .byte   $62, $43, $20, $01, $E6, $C7, $A4, $85
+        .byte   $6A, $4B, $28, $09, $EE, $CF, $AC, $8D
+        .byte   $53, $72, $11, $30, $D7, $F6, $95, $B4
+        .byte   $5B, $7A, $19, $38, $DF, $FE, $9D, $BC
+        .byte   $C4, $E5, $86, $A7, $40, $61, $02, $23
+        .byte   $CC, $ED, $8E, $AF, $48, $69, $0A, $2B
+        .byte   $F5, $D4, $B7, $96, $71, $50, $33, $12
+        .byte   $FD, $DC, $BF, $9E, $79, $58, $3B, $1A
+        .byte   $A6, $87, $E4, $C5, $22, $03, $60, $41
+        .byte   $AE, $8F, $EC, $CD, $2A, $0B, $68, $49
+        .byte   $97, $B6, $D5, $F4, $13, $32, $51, $70
+        .byte   $9F, $BE, $DD, $FC, $1B, $3A, $59, $78
+        .byte   $88, $A9, $CA, $EB, $0C, $2D, $4E, $6F
+        .byte   $80, $A1, $C2, $E3, $04, $25, $46, $67
+        .byte   $B9, $98, $FB, $DA, $3D, $1C, $7F, $5E
+        .byte   $B1, $90, $F3, $D2, $35, $14, $77, $56
+        .byte   $EA, $CB, $A8, $89, $6E, $4F, $2C, $0D
+        .byte   $E2, $C3, $A0, $81, $66, $47, $24, $05
+        .byte   $DB, $FA, $99, $B8, $5F, $7E, $1D, $3C
+        .byte   $D3, $F2, $91, $B0, $57, $76, $15, $34
+        .byte   $4C, $6D, $0E, $2F, $C8, $E9, $8A, $AB
+        .byte   $44, $65, $06, $27, $C0, $E1, $82, $A3
+        .byte   $7D, $5C, $3F, $1E, $F9, $D8, $BB, $9A
+        .byte   $75, $54, $37, $16, $F1, $D0, $B3, $92
+        .byte   $2E, $0F, $6C, $4D, $AA, $8B, $E8, $C9
+        .byte   $26, $07, $64, $45, $A2, $83, $E0, $C1
+        .byte   $1F, $3E, $5D, $7C, $9B, $BA, $D9, $F8
+        .byte   $17, $36, $55, $74, $93, $B2, $D1, $F0
+
+crc_table_hi:
+        .byte   $00, $10, $20, $30, $40, $50, $60, $70
+        .byte   $81, $91, $A1, $B1, $C1, $D1, $E1, $F1
+        .byte   $12, $02, $32, $22, $52, $42, $72, $62
+        .byte   $93, $83, $B3, $A3, $D3, $C3, $F3, $E3
+        .byte   $24, $34, $04, $14, $64, $74, $44, $54
+        .byte   $A5, $B5, $85, $95, $E5, $F5, $C5, $D5
+        .byte   $36, $26, $16, $06, $76, $66, $56, $46
+        .byte   $B7, $A7, $97, $87, $F7, $E7, $D7, $C7
+        .byte   $48, $58, $68, $78, $08, $18, $28, $38
+        .byte   $C9, $D9, $E9, $F9, $89, $99, $A9, $B9
+        .byte   $5A, $4A, $7A, $6A, $1A, $0A, $3A, $2A
+        .byte   $DB, $CB, $FB, $EB, $9B, $8B, $BB, $AB
+        .byte   $6C, $7C, $4C, $5C, $2C, $3C, $0C, $1C
+        .byte   $ED, $FD, $CD, $DD, $AD, $BD, $8D, $9D
+        .byte   $7E, $6E, $5E, $4E, $3E, $2E, $1E, $0E
+        .byte   $FF, $EF, $DF, $CF, $BF, $AF, $9F, $8F
+        .byte   $91, $81, $B1, $A1, $D1, $C1, $F1, $E1
+        .byte   $10, $00, $30, $20, $50, $40, $70, $60
+        .byte   $83, $93, $A3, $B3, $C3, $D3, $E3, $F3
+        .byte   $02, $12, $22, $32, $42, $52, $62, $72
+        .byte   $B5, $A5, $95, $85, $F5, $E5, $D5, $C5
+        .byte   $34, $24, $14, $04, $74, $64, $54, $44
+        .byte   $A7, $B7, $87, $97, $E7, $F7, $C7, $D7
+        .byte   $26, $36, $06, $16, $66, $76, $46, $56
+        .byte   $D9, $C9, $F9, $E9, $99, $89, $B9, $A9
+        .byte   $58, $48, $78, $68, $18, $08, $38, $28
+        .byte   $CB, $DB, $EB, $FB, $8B, $9B, $AB, $BB
+        .byte   $4A, $5A, $6A, $7A, $0A, $1A, $2A, $3A
+        .byte   $FD, $ED, $DD, $CD, $BD, $AD, $9D, $8D
+        .byte   $7C, $6C, $5C, $4C, $3C, $2C, $1C, $0C
+        .byte   $EF, $FF, $CF, $DF, $AF, $BF, $8F, $9F
+        .byte   $6E, $7E, $4E, $5E, $2E, $3E, $0E, $1E
@@ -0,0 +1,84 @@
+//   _____  ___________              _______________
+//   __  / / /__  /_  /_____________ __|__  /_  ___/
+//   _  / / /__  /_  __/_  ___/  __ `/__/_ <_  __ \
+//   / /_/ / _  / / /_ _  /   / /_/ /____/ // /_/ /
+//   \____/  /_/  \__/ /_/    \__,_/ /____/ \____/
+// Ultra-36 Rom Switcher for Commodore 128 - C128 Menu Program - scheduler.c
+// Free for personal use.
+// Commercial use or resale (in whole or part) prohibited without permission.
+// (c) 2025 Lukasz Dziwosz / LukasSoft. All Rights Reserved.
+
+#include <peekpoke.h>
+#include "scheduler.h"
+
+// Low byte of the kernal jiffy clock (TIME, $A0-$A2)
+#define JIFFY_LOW   0xA2
+// Kernal video standard flag (PALNTS): $FF on PAL machines, 0 on NTSC
+#define PALNTS      0x0A03
+
+struct task tasks[TASK_COUNT];
+unsigned char ticks_per_second;
+
+// The jiffy clock runs at the frame rate of the video standard
+void scheduler_init(void)
+{
+    ticks_per_second = PEEK(PALNTS) ? 50 : 60;
+}
+
+void task_define(unsigned char id, task_fn run, unsigned char period,
+                 unsigned char budget)
+{
+    tasks[id].run = run;
+    tasks[id].period = period;
+    tasks[id].budget = budget;
+    tasks[id].started = 0;
+    tasks[id].overruns = 0;
+}
+
+// First run one period from now
+void __fastcall__ task_start(unsigned char id)
+{
+    tasks[id].due = PEEK(JIFFY_LOW) + tasks[id].period;
+    tasks[id].started = 1;
+}
+
+void __fastcall__ task_stop(unsigned char id)
+{
+    tasks[id].started = 0;
+}
+
+unsigned char scheduler_ticks(void)
+{
+    return PEEK(JIFFY_LOW);
+}
+
+void scheduler_step(void)
+{
+    struct task *task;
+    unsigned char now;
+    unsigned char wait;
+    unsigned char id;
+
+    for (id = 0; id < TASK_COUNT; ++id) {
+        task = &tasks[id];
+        now = PEEK(JIFFY_LOW);
+        // Due ticks wrap with the clock. A task only waits while its due
+        // tick is 1..period ahead; any other distance, including one left
+        // by a run that overran by more than 127 ticks, makes it due now.
+        wait = task->due - now;
+        if (!task->started || (wait != 0 && wait <= task->period))
+            continue;
+        task->due = now + task->period;
+        task->run();
+        if ((unsigned char)(PEEK(JIFFY_LOW) - now) > task->budget)
+            ++task->overruns;
+    }
+}
+
+// Blocking pause for the few places that must not go on before it ends
+void __fastcall__ scheduler_wait(unsigned char ticks)
+{
+    unsigned char start = PEEK(JIFFY_LOW);
+
+    while ((unsigned char)(PEEK(JIFFY_LOW) - start) < ticks) {}
+}
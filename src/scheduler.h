@@ -0,0 +1,45 @@
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+/*
+ * Cooperative task scheduler for the menu main loop. Time is counted in
+ * ticks of the kernal jiffy clock, which the raster IRQ advances once per
+ * frame. scheduler_step() runs every started task whose period has elapsed,
+ * in task order, so each one must return quickly and spread longer work
+ * over several ticks. A run that takes longer than the task's budget is
+ * counted as an overrun.
+ */
+#define TASK_INPUT          0   // Keyboard and key dispatch (main.c)
+#define TASK_REDRAW         1   // Pending full-page repaint (main.c)
+#define TASK_SERIAL         2   // Queued Ultra-36 command (main.c)
+#define TASK_STATUS         3   // Status line expiry (main.c)
+#define TASK_SID            4   // SID check playback (sid_info_screen.c)
+#define TASK_COUNT          5
+
+// One IRQ per frame: 60 on NTSC, 50 on PAL machines (scheduler_init())
+#define TICKS_PER_SECOND    ticks_per_second
+
+typedef void (*task_fn)(void);
+
+struct task {
+    task_fn run;
+    unsigned char period;       // Ticks from one run to the next
+    unsigned char budget;       // Ticks a run may take
+    unsigned char due;          // Tick of the next run
+    unsigned char started;
+    unsigned int overruns;
+};
+
+extern struct task tasks[TASK_COUNT];
+extern unsigned char ticks_per_second;
+
+void scheduler_init(void);
+void task_define(unsigned char id, task_fn run, unsigned char period,
+                 unsigned char budget);
+void __fastcall__ task_start(unsigned char id);
+void __fastcall__ task_stop(unsigned char id);
+unsigned char scheduler_ticks(void);
+void scheduler_step(void);
+void __fastcall__ scheduler_wait(unsigned char ticks);
+
+#endif
@@ -13,6 +13,11 @@
 #include <stdio.h>
 #include <c128.h>
 #include "sid_info_screen.h"
+#include "warm_state.h"
+#include "profile.h"
+#include "redraw.h"
+#include "ui_strings.h"
+#include "scheduler.h"
 
 #define SID1_BASE       0xD400
 
@@ -33,6 +38,13 @@
 #define SID_MODE_VOLUME 0x18
 #define SID_OSC3        0x1B
 
+/* Sound check phases, advanced one step per scheduler tick */
+#define PLAY_IDLE       0
+#define PLAY_OPEN       1
+#define PLAY_CLOSE      2
+#define PLAY_RELEASE    3
+#define PLAY_FADE       4
+
 #define SID2_ADDRESS_COUNT 4
 #define SID2_FIRST_ROW     9
 
@@ -60,7 +72,27 @@ static const unsigned int voice3_notes[4] = {
     0x0D0C, 0x1168, 0x138A, 0x15F0
 };
 
+static const struct ui_line sid_page_text[] = {
+    {0, 3, COLOR_WHITE, UI_SID_DETECT},
+    {0, 7, COLOR_WHITE, UI_SID_SELECT},
+    {0, 14, COLOR_WHITE, UI_SID_HELP_SELECT},
+    {0, 15, COLOR_WHITE, UI_SID_HELP_SID1},
+    {0, 16, COLOR_WHITE, UI_SID_HELP_SID2},
+    {0, 19, COLOR_WHITE, UI_SID_LISTEN},
+    {0, 20, COLOR_WHITE, UI_SID_NO_SCAN},
+    {0, 22, COLOR_WHITE, UI_SID_IO_MAP}
+};
+
 static unsigned char sid2_selected = 1;
+static unsigned char sid_screen_width;
+
+static struct {
+    unsigned int base;
+    unsigned int cutoff;
+    unsigned char phase;
+    unsigned char chord;
+    unsigned char count;    /* Sweep step, release frames or volume */
+} play;
 
 static void reset_sid(unsigned int base)
 {
@@ -70,24 +102,6 @@ static void reset_sid(unsigned int base)
         POKE(base + i, 0x00);
 }
 
-/*
- * Wait for the VIC raster to reach line 240. This keeps the test tempo stable
- * in both 1 MHz VIC mode and 2 MHz VDC mode without depending on CPU loops.
- */
-static void wait_sid_frame(void)
-{
-    while (PEEK(0xD012) == 0xF0) {}
-    while (PEEK(0xD012) != 0xF0) {}
-}
-
-static void wait_sid_frames(unsigned char count)
-{
-    while (count != 0) {
-        wait_sid_frame();
-        --count;
-    }
-}
-
 static void set_sid_frequency(unsigned int base, unsigned char voice,
                               unsigned int frequency)
 {
@@ -117,15 +131,13 @@ static void set_sid_chord(unsigned int base, unsigned char chord)
 /*
  * Play a short three-voice musical phrase through a strongly resonant
  * low-pass filter. Hearing it from the expected output is the SID 2 test;
- * no unreliable register-read address scan is attempted.
+ * no unreliable register-read address scan is attempted. sid_play_start()
+ * sets the voices up and sid_play_step() then moves the phrase on by one
+ * video frame, so the tempo follows the jiffy clock in both 1 MHz VIC mode
+ * and 2 MHz VDC mode and the menu keeps running in between.
  */
-static void play_sid_sound_check(unsigned int base)
+static void sid_play_start(unsigned int base)
 {
-    unsigned int cutoff;
-    unsigned char chord;
-    unsigned char sweep_step;
-    unsigned char volume;
-
     reset_sid(base);
 
     set_sid_chord(base, 0);
@@ -148,43 +160,78 @@ static void play_sid_sound_check(unsigned int base)
     POKE(base + 0x07 + SID_CONTROL, 0x41);
     POKE(base + 0x0E + SID_CONTROL, 0x11);
 
-    /*
-     * Open the filter while moving through the chord progression. One cutoff
-     * step per video frame produces a smooth, repeatable sweep.
-     */
-    cutoff = 0x0080;
-    chord = 0;
-    sweep_step = 0;
-    while (cutoff < 0x0780) {
-        set_sid_cutoff(base, cutoff);
-        wait_sid_frame();
-        cutoff += 0x18;
-        ++sweep_step;
-        if (sweep_step == 24) {
-            sweep_step = 0;
-            chord = (unsigned char)((chord + 1) & 0x03);
-            set_sid_chord(base, chord);
+    play.base = base;
+    play.cutoff = 0x0080;
+    play.chord = 0;
+    play.count = 0;
+    play.phase = PLAY_OPEN;
+}
+
+/* Returns 0 once the phrase has faded out and the SID is silent again. */
+static unsigned char sid_play_step(void)
+{
+    unsigned int base = play.base;
+
+    switch (play.phase) {
+    case PLAY_OPEN:
+        /*
+         * Open the filter while moving through the chord progression. One
+         * cutoff step per video frame produces a smooth, repeatable sweep.
+         */
+        play.cutoff += 0x18;
+        if (++play.count == 24) {
+            play.count = 0;
+            play.chord = (unsigned char)((play.chord + 1) & 0x03);
+            set_sid_chord(base, play.chord);
+        }
+        if (play.cutoff < 0x0780) {
+            set_sid_cutoff(base, play.cutoff);
+            break;
         }
-    }
 
-    /* Close the filter with maximum resonance for a clear second pass. */
-    POKE(base + SID_RESONANCE, 0xF7);
-    while (cutoff > 0x0120) {
-        cutoff -= 0x20;
-        set_sid_cutoff(base, cutoff);
-        wait_sid_frame();
+        /* Close the filter with maximum resonance for a clear second pass. */
+        POKE(base + SID_RESONANCE, 0xF7);
+        play.phase = PLAY_CLOSE;
+        /* fall through */
+    case PLAY_CLOSE:
+        if (play.cutoff > 0x0120) {
+            play.cutoff -= 0x20;
+            set_sid_cutoff(base, play.cutoff);
+            break;
+        }
+        POKE(base + 0x00 + SID_CONTROL, 0x20);
+        POKE(base + 0x07 + SID_CONTROL, 0x40);
+        POKE(base + 0x0E + SID_CONTROL, 0x10);
+        play.count = 10;
+        play.phase = PLAY_RELEASE;
+        break;
+    case PLAY_RELEASE:
+        if (--play.count != 0)
+            break;
+        play.count = 15;
+        play.phase = PLAY_FADE;
+        /* fall through */
+    case PLAY_FADE:
+        if (play.count != 0) {
+            POKE(base + SID_MODE_VOLUME, (unsigned char)(0x10 | play.count));
+            --play.count;
+            break;
+        }
+        reset_sid(base);
+        play.phase = PLAY_IDLE;
+        break;
     }
+    return play.phase != PLAY_IDLE;
+}
 
-    POKE(base + 0x00 + SID_CONTROL, 0x20);
-    POKE(base + 0x07 + SID_CONTROL, 0x40);
-    POKE(base + 0x0E + SID_CONTROL, 0x10);
-    wait_sid_frames(10);
-
-    for (volume = 15; volume != 0; --volume) {
-        POKE(base + SID_MODE_VOLUME, (unsigned char)(0x10 | volume));
-        wait_sid_frame();
+/* Cuts a running sound check short, e.g. when the page is left. */
+static void sid_play_stop(void)
+{
+    task_stop(TASK_SID);
+    if (play.phase != PLAY_IDLE) {
+        reset_sid(play.base);
+        play.phase = PLAY_IDLE;
     }
-    reset_sid(base);
 }
 
 /*
@@ -257,65 +304,91 @@ static void show_test_status(unsigned char screen_width, const char* label,
     textcolor(COLOR_WHITE);
 }
 
+static void start_sound_check(const char* label, unsigned int base)
+{
+    /* One phrase at a time; the keys stay live while it plays */
+    if (play.phase != PLAY_IDLE)
+        return;
+    show_test_status(sid_screen_width, label, base);
+    sid_play_start(base);
+    task_start(TASK_SID);
+}
+
+/* Scheduler task: one sound check step per tick, then the result line. */
+void sid_play_task(void)
+{
+    if (sid_play_step())
+        return;
+
+    task_stop(TASK_SID);
+    cclearxy(0, 17, sid_screen_width);
+    if (play.base == SID1_BASE) {
+        ui_putsxy(0, 17, UI_SID_SID1_DONE);
+    } else {
+        gotoxy(0, 17);
+        cprintf("SID 2 $%04X check complete.", play.base);
+    }
+}
+
 void draw_sid_info_screen(unsigned char screen_width)
 {
     static const char* sid_model_name[] = {
         "", "MOS 6581", "MOS 8580", "Unknown model"
     };
     unsigned char sid1;
-    unsigned char key;
     unsigned char i;
-    unsigned int sid2_address;
 
+    PROFILE_ENTER(PROF_DRAW_SID_INFO);
+    sid_screen_width = screen_width;
+    redraw_begin();
     for (i = 2; i < 25; ++i)
         cclearxy(0, i, screen_width);
 
     draw_sub_title_bar(screen_width);
-    textcolor(COLOR_WHITE);
-    cputsxy(0, 3, "SID 1 model detection ($D400)");
-
-    sid1 = detect_sid1_model();
+    ui_put_lines(sid_page_text, 8);
+
+    // Probe once per power-on; later visits and resets reuse the result
+    if (warm_state.sid1_model == 0) {
+        PROFILE_ENTER(PROF_DETECT_SID1);
+        warm_state.sid1_model = detect_sid1_model();
+        PROFILE_LEAVE(PROF_DETECT_SID1);
+        warm_state.sid2_selected = sid2_selected;
+    } else if (warm_state.sid2_selected < SID2_ADDRESS_COUNT) {
+        sid2_selected = warm_state.sid2_selected;
+    }
+    warm_state_seal();
+    sid1 = warm_state.sid1_model;
     gotoxy(0, 5);
     cprintf("SID 1: %s", sid_model_name[sid1]);
 
-    cputsxy(0, 7, "Select the second SID address:");
     draw_sid2_options(sid2_selected);
+    redraw_end();
+    PROFILE_LEAVE(PROF_DRAW_SID_INFO);
+}
 
-    cputsxy(0, 14, "UP/DOWN  Select SID 2 address");
-    cputsxy(0, 15, "F1       Sound check SID 1");
-    cputsxy(0, 16, "F2/RETURN Sound check selected SID 2");
-    cputsxy(0, 19, "Listen at each output to confirm SID 2.");
-    cputsxy(0, 20, "No SID 2 address scan or model guess.");
-    cputsxy(0, 22, "C128: $D500 is MMU, $D600 is VDC.");
-
-    while (1) {
-        key = cgetc();
-
-        if (key == CH_CURS_UP) {
-            if (sid2_selected == 0)
-                sid2_selected = SID2_ADDRESS_COUNT - 1;
-            else
-                --sid2_selected;
-            draw_sid2_options(sid2_selected);
-        } else if (key == CH_CURS_DOWN) {
-            ++sid2_selected;
-            if (sid2_selected == SID2_ADDRESS_COUNT)
-                sid2_selected = 0;
-            draw_sid2_options(sid2_selected);
-        } else if (key == CH_F1) {
-            show_test_status(screen_width, "SID 1", SID1_BASE);
-            play_sid_sound_check(SID1_BASE);
-            cclearxy(0, 17, screen_width);
-            cputsxy(0, 17, "SID 1 sound check complete.");
-        } else if (key == CH_F2 || key == CH_ENTER) {
-            sid2_address = sid2_addresses[sid2_selected];
-            show_test_status(screen_width, "SID 2", sid2_address);
-            play_sid_sound_check(sid2_address);
-            cclearxy(0, 17, screen_width);
-            gotoxy(0, 17);
-            cprintf("SID 2 $%04X check complete.", sid2_address);
-        } else if (key == CH_F8) {
-            break;
-        }
+/* Handles a key on the SID page. Returns 1 when F8 leaves the page. */
+unsigned char __fastcall__ sid_info_key(unsigned char key)
+{
+    if (key == CH_CURS_UP) {
+        if (sid2_selected == 0)
+            sid2_selected = SID2_ADDRESS_COUNT - 1;
+        else
+            --sid2_selected;
+        draw_sid2_options(sid2_selected);
+    } else if (key == CH_CURS_DOWN) {
+        ++sid2_selected;
+        if (sid2_selected == SID2_ADDRESS_COUNT)
+            sid2_selected = 0;
+        draw_sid2_options(sid2_selected);
+    } else if (key == CH_F1) {
+        start_sound_check("SID 1", SID1_BASE);
+    } else if (key == CH_F2 || key == CH_ENTER) {
+        start_sound_check("SID 2", sid2_addresses[sid2_selected]);
+    } else if (key == CH_F8) {
+        sid_play_stop();
+        warm_state.sid2_selected = sid2_selected;
+        warm_state_seal();
+        return 1;
     }
+    return 0;
 }
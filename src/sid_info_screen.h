@@ -3,4 +3,10 @@
 
 void draw_sid_info_screen(unsigned char screen_width);
 
+// Returns 1 when F8 leaves the page
+unsigned char __fastcall__ sid_info_key(unsigned char key);
+
+// TASK_SID: plays the sound check started from the page
+void sid_play_task(void);
+
 #endif
@@ -0,0 +1,14 @@
+#ifndef STACK_USAGE_H
+#define STACK_USAGE_H
+
+// The startup paints the free stack space before main() runs
+// (src/stack_usage.s); these report what was never written since then.
+
+// Bytes of the C stack area still unused, out of stack_c_size
+unsigned int stack_c_free(void);
+extern const unsigned int stack_c_size;
+
+// Bytes of the CPU stack between $0140 and the deepest push still unused
+unsigned char stack_cpu_free(void);
+
+#endif
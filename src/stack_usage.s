@@ -0,0 +1,99 @@
+;
+; Ultra-36 Rom Switcher for Commodore 128 - C128 Menu Program - stack_usage.s
+; Stack painting: the startup fills the free C and CPU stack with a marker
+; byte, and the high-water mark is wherever the marker has been overwritten.
+;
+; (c) 2025 Lukasz Dziwosz / LukasSoft. All Rights Reserved.
+;
+
+    .export     stack_paint
+    .export     _stack_c_free, _stack_cpu_free, _stack_c_size
+    .import     __CSTACK_START__, __CSTACK_SIZE__
+    .importzp   ptr1
+
+; ------------------------------------------------------------------------
+; Constants
+
+STACK_MARK      = $A5
+CPU_STACK_FLOOR = $40           ; $0100-$013F belong to the kernal and BASIC
+
+.code
+
+; ------------------------------------------------------------------------
+; Paint the whole C stack area (page aligned, see the .cfg files) and the
+; CPU stack from below the caller's return address down to the floor. Must
+; be called with an empty C stack.
+
+stack_paint:
+        lda     #<__CSTACK_START__
+        sta     ptr1
+        lda     #>__CSTACK_START__
+        sta     ptr1+1
+        ldy     #0
+        lda     #STACK_MARK
+@c:     sta     (ptr1),y
+        iny
+        bne     @c
+        inc     ptr1+1
+        ldx     ptr1+1
+        cpx     #>(__CSTACK_START__ + __CSTACK_SIZE__)
+        bne     @c
+
+        tsx
+        cpx     #CPU_STACK_FLOOR
+        bcc     @done
+@cpu:   sta     $0100,x
+        dex
+        cpx     #CPU_STACK_FLOOR - 1
+        bne     @cpu
+@done:  rts
+
+; ------------------------------------------------------------------------
+; unsigned int stack_c_free(void)
+; Bytes at the bottom of the C stack that still hold the marker. The C stack
+; is never empty while main() runs, so the scan always stops inside it.
+
+_stack_c_free:
+        lda     #<__CSTACK_START__
+        sta     ptr1
+        lda     #>__CSTACK_START__
+        sta     ptr1+1
+        ldy     #0
+@scan:  lda     (ptr1),y
+        cmp     #STACK_MARK
+        bne     @found
+        iny
+        bne     @scan
+        inc     ptr1+1
+        bne     @scan
+@found: lda     ptr1+1
+        sec
+        sbc     #>__CSTACK_START__
+        tax
+        tya
+        rts
+
+; ------------------------------------------------------------------------
+; unsigned char stack_cpu_free(void)
+; Bytes above the floor of the CPU stack that still hold the marker.
+
+_stack_cpu_free:
+        ldx     #CPU_STACK_FLOOR
+@scan:  lda     $0100,x
+        cmp     #STACK_MARK
+        bne     @found
+        inx
+        bne     @scan
+@found: txa
+        sec
+        sbc     #CPU_STACK_FLOOR
+        ldx     #0
+        rts
+
+; ------------------------------------------------------------------------
+; Size of the C stack area, from the linker configuration
+
+.rodata
+
+_stack_c_size:
+        .word   __CSTACK_SIZE__
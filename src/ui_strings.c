@@ -0,0 +1,79 @@
+//   _____  ___________              _______________
+//   __  / / /__  /_  /_____________ __|__  /_  ___/
+//   _  / / /__  /_  __/_  ___/  __ `/__/_ <_  __ \
+//   / /_/ / _  / / /_ _  /   / /_/ /____/ // /_/ /
+//   \____/  /_/  \__/ /_/    \__,_/ /____/ \____/
+// Ultra-36 Rom Switcher for Commodore 128 - C128 Menu Program - ui_strings.c
+// Free for personal use.
+// Commercial use or resale (in whole or part) prohibited without permission.
+// (c) 2025 Lukasz Dziwosz / LukasSoft. All Rights Reserved.
+
+#include <conio.h>
+#include <c128.h>
+#include "ui_strings.h"
+#include "ui_string_data.h"
+#include "display.h"
+
+static char ui_buffer[UI_TEXT_MAX + 1];
+
+unsigned char __fastcall__ ui_expand(unsigned char id, char *out)
+{
+    const unsigned char *source = ui_texts + ui_text_offset[id];
+    const unsigned char *token;
+    const unsigned char *end;
+    unsigned char length = 0;
+    unsigned char c;
+
+    while ((c = *source++) != 0)
+    {
+        c -= UI_TOKEN_FIRST;
+        if (c < UI_TOKEN_COUNT)
+        {
+            // Tokens hold plain characters only, so one copy expands them
+            token = ui_tokens + ui_token_offset[c];
+            end = ui_tokens + ui_token_offset[c + 1];
+            while (token != end)
+                out[length++] = *token++;
+        }
+        else
+            out[length++] = c + UI_TOKEN_FIRST;
+    }
+    out[length] = 0;
+    return length;
+}
+
+const char * __fastcall__ ui_text(unsigned char id)
+{
+    ui_expand(id, ui_buffer);
+    return ui_buffer;
+}
+
+void __fastcall__ ui_putsxy(unsigned char x, unsigned char y, unsigned char id)
+{
+    unsigned char length;
+    unsigned char colour;
+    unsigned char i;
+    unsigned int offset;
+
+    length = ui_expand(id, ui_buffer);
+    for (i = 0; i < length; i++)
+        ui_buffer[i] = display_screen_code(ui_buffer[i]);
+
+    // conio has no getter for the text colour
+    colour = textcolor(COLOR_WHITE);
+    textcolor(colour);
+
+    offset = display->row_offset[y] + x;
+    display->put_span(offset, (const unsigned char *)ui_buffer, length);
+    display->set_colour(offset, colour, length);
+    gotoxy(x + length, y);
+}
+
+void __fastcall__ ui_put_lines(const struct ui_line *lines, unsigned char count)
+{
+    for (; count != 0; count--, lines++)
+    {
+        textcolor(lines->colour);
+        ui_putsxy(lines->x, lines->y, lines->id);
+    }
+}
@@ -0,0 +1,34 @@
+#ifndef UI_STRINGS_H
+#define UI_STRINGS_H
+
+/*
+ * Menu texts from src/ui_strings.txt, stored token-compressed (see
+ * scripts/compress_strings.py). UI_* numbers come from the generated
+ * ui_string_ids.h.
+ */
+#include "ui_string_ids.h"
+
+// Expands a text into out (UI_TEXT_MAX + 1 bytes); returns its length
+unsigned char __fastcall__ ui_expand(unsigned char id, char *out);
+
+// Expanded text in a buffer shared by all calls, for printf formats
+const char * __fastcall__ ui_text(unsigned char id);
+
+// cputsxy() replacement: writes the text as screen codes through the
+// display driver in the current text colour (not reversed) and leaves the
+// cursor after it
+void __fastcall__ ui_putsxy(unsigned char x, unsigned char y, unsigned char id);
+
+// One row of a page's fixed text
+struct ui_line
+{
+    unsigned char x;
+    unsigned char y;
+    unsigned char colour;
+    unsigned char id;
+};
+
+// Writes 'count' rows with ui_putsxy(); the last row's colour stays set
+void __fastcall__ ui_put_lines(const struct ui_line *lines, unsigned char count);
+
+#endif
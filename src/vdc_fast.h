@@ -0,0 +1,31 @@
+#ifndef VDC_FAST_H
+#define VDC_FAST_H
+
+// Kernal editor screen layout in VDC RAM (16K addressing)
+#define VDC_SCREEN_RAM      0x0000
+#define VDC_ATTR_RAM        0x0800
+#define VDC_TEXT_RAM_SIZE   0x0800
+
+// VDC attribute byte bits
+#define VDC_ATTR_ALTCHARSET 0x80
+#define VDC_ATTR_REVERSE    0x40
+
+// Register/value table terminator for vdc_write_regs()
+#define VDC_REGS_END        0xFF
+
+void __fastcall__ vdc_write(unsigned char reg, unsigned char value);
+unsigned char __fastcall__ vdc_read(unsigned char reg);
+void __fastcall__ vdc_set_address(unsigned int address);
+void vdc_wait(void);
+void __fastcall__ vdc_write_regs(const unsigned char *table);
+void __fastcall__ vdc_write_run(const unsigned char *src, unsigned char count);
+unsigned char __fastcall__ vdc_verify_run(unsigned char expected,
+                                          unsigned char count);
+void __fastcall__ vdc_fill(unsigned int address, unsigned char value,
+                           unsigned int count);
+void __fastcall__ vdc_copy(unsigned int dest, unsigned int source,
+                           unsigned int count);
+
+extern const unsigned char vdc_rgbi[16];
+
+#endif
@@ -0,0 +1,273 @@
+;
+; Ultra-36 Rom Switcher for Commodore 128 - C128 Menu Program - vdc_fast.s
+; VDC access layer: table-driven register writes, address-set-then-stream
+; transfers and block fill/copy, all with the ready poll inlined.
+;
+; (c) 2025 Lukasz Dziwosz / LukasSoft. All Rights Reserved.
+;
+
+    .export     _vdc_write, _vdc_read, _vdc_set_address, _vdc_wait
+    .export     _vdc_write_regs, _vdc_write_run, _vdc_verify_run
+    .export     _vdc_fill, _vdc_copy
+    .export     _vdc_rgbi
+    .import     popa, popax
+    .importzp   ptr1, ptr2, tmp1, tmp2, tmp3
+
+; ------------------------------------------------------------------------
+; Constants
+
+VDC_CTRL            = $D600     ; Register select (write) / status (read)
+VDC_PORT            = $D601     ; Register data
+
+; The sim65 cycle benchmark (bench/) has plain RAM at $D600, so the status
+; poll reads a byte that always reports ready; every access still pays the
+; cost of one successful poll.
+.ifdef BENCH
+        .import     _bench_vdc_status
+VDC_STATUS          = _bench_vdc_status
+.else
+VDC_STATUS          = VDC_CTRL
+.endif
+
+VDC_REG_HIGH_ADDR   = 18
+VDC_REG_LOW_ADDR    = 19
+VDC_REG_VSCROLL     = 24        ; Bit 7: block copy (1) or block fill (0)
+VDC_REG_WORD_COUNT  = 30
+VDC_REG_DATA        = 31
+VDC_REG_BLOCK_SRC_HI = 32
+VDC_REG_BLOCK_SRC_LO = 33
+
+VDC_BLOCK_COPY      = $80
+VDC_BLOCK_CHUNK     = $80       ; Word count per block op, two per page
+
+; ------------------------------------------------------------------------
+; Spin until the VDC status ready bit (bit 7) is set.
+
+.macro  vdc_ready
+:       bit     VDC_STATUS
+        bpl     :-
+.endmacro
+
+; Select register reg and wait until the VDC accepts the access.
+
+.macro  vdc_select reg
+        ldx     #reg
+        stx     VDC_CTRL
+        vdc_ready
+.endmacro
+
+.code
+
+; ------------------------------------------------------------------------
+; void __fastcall__ vdc_write(unsigned char reg, unsigned char value);
+
+_vdc_write:
+        pha
+        jsr     popa            ; Register number
+        sta     VDC_CTRL
+        pla
+        vdc_ready
+        sta     VDC_PORT
+        rts
+
+; ------------------------------------------------------------------------
+; unsigned char __fastcall__ vdc_read(unsigned char reg);
+
+_vdc_read:
+        sta     VDC_CTRL
+        vdc_ready
+        lda     VDC_PORT
+        ldx     #0
+        rts
+
+; ------------------------------------------------------------------------
+; void __fastcall__ vdc_set_address(unsigned int address);
+; Preserves A and X.
+
+_vdc_set_address:
+        ldy     #VDC_REG_HIGH_ADDR
+        sty     VDC_CTRL
+        vdc_ready
+        stx     VDC_PORT
+        iny                     ; VDC_REG_LOW_ADDR
+        sty     VDC_CTRL
+        vdc_ready
+        sta     VDC_PORT
+        rts
+
+; ------------------------------------------------------------------------
+; void vdc_wait(void);
+; Wait for the last block operation to finish.
+
+_vdc_wait:
+        vdc_ready
+        rts
+
+; ------------------------------------------------------------------------
+; void __fastcall__ vdc_write_regs(const unsigned char *table);
+; Table of register/value pairs, terminated by a register number >= $80.
+
+_vdc_write_regs:
+        sta     ptr1
+        stx     ptr1+1
+        ldy     #0
+@next:  lda     (ptr1),y
+        bmi     @done
+        sta     VDC_CTRL
+        iny
+        lda     (ptr1),y
+        iny
+        vdc_ready
+        sta     VDC_PORT
+        jmp     @next
+@done:  rts
+
+; ------------------------------------------------------------------------
+; void __fastcall__ vdc_write_run(const unsigned char *src,
+;                                 unsigned char count);
+; Stream count bytes (0 = 256) to the current update address.
+
+_vdc_write_run:
+        sta     tmp1
+        jsr     popax
+        sta     ptr1
+        stx     ptr1+1
+        vdc_select VDC_REG_DATA
+        ldy     #0
+@loop:  lda     (ptr1),y
+        vdc_ready
+        sta     VDC_PORT
+        iny
+        cpy     tmp1
+        bne     @loop
+        rts
+
+; ------------------------------------------------------------------------
+; unsigned char __fastcall__ vdc_verify_run(unsigned char expected,
+;                                           unsigned char count);
+; Read count bytes (0 = 256) from the current update address and return
+; the OR of every bit that differs from expected.
+
+_vdc_verify_run:
+        sta     tmp1
+        jsr     popa
+        sta     tmp2
+        lda     #0
+        sta     tmp3
+        vdc_select VDC_REG_DATA
+        ldy     #0
+@loop:  vdc_ready
+        lda     VDC_PORT
+        eor     tmp2
+        ora     tmp3
+        sta     tmp3
+        iny
+        cpy     tmp1
+        bne     @loop
+        lda     tmp3
+        ldx     #0
+        rts
+
+; ------------------------------------------------------------------------
+; void __fastcall__ vdc_fill(unsigned int address, unsigned char value,
+;                            unsigned int count);
+; Hardware block fill. The first byte goes through the data register, the
+; VDC repeats it for every word count written to register 30.
+
+_vdc_fill:
+        sta     ptr1            ; Count
+        stx     ptr1+1
+        jsr     popa
+        sta     tmp1            ; Value
+        jsr     popax           ; Address
+        ldy     ptr1
+        bne     @some
+        ldy     ptr1+1
+        beq     @none
+@some:  jsr     _vdc_set_address
+
+        vdc_select VDC_REG_VSCROLL
+        lda     VDC_PORT
+        and     #<~VDC_BLOCK_COPY
+        vdc_ready
+        sta     VDC_PORT
+
+        vdc_select VDC_REG_DATA
+        lda     tmp1
+        sta     VDC_PORT
+
+        lda     ptr1            ; One byte already written
+        bne     @dec
+        dec     ptr1+1
+@dec:   dec     ptr1
+        jmp     block_run
+@none:  rts
+
+; ------------------------------------------------------------------------
+; void __fastcall__ vdc_copy(unsigned int dest, unsigned int source,
+;                            unsigned int count);
+; Hardware block copy. Leaves register 24 in fill mode, as the kernal
+; expects.
+
+_vdc_copy:
+        sta     ptr1            ; Count
+        stx     ptr1+1
+        jsr     popax
+        sta     ptr2            ; Source
+        stx     ptr2+1
+        jsr     popax           ; Destination
+        jsr     _vdc_set_address
+
+        vdc_select VDC_REG_VSCROLL
+        lda     VDC_PORT
+        ora     #VDC_BLOCK_COPY
+        vdc_ready
+        sta     VDC_PORT
+
+        vdc_select VDC_REG_BLOCK_SRC_HI
+        lda     ptr2+1
+        sta     VDC_PORT
+        vdc_select VDC_REG_BLOCK_SRC_LO
+        lda     ptr2
+        sta     VDC_PORT
+
+        jsr     block_run
+
+        vdc_select VDC_REG_VSCROLL
+        lda     VDC_PORT
+        and     #<~VDC_BLOCK_COPY
+        vdc_ready
+        sta     VDC_PORT
+        rts
+
+; ------------------------------------------------------------------------
+; Issue word counts for the ptr1 bytes still to fill or copy: two chunks
+; per 256-byte page, then the remainder.
+
+block_run:
+        ldx     #VDC_REG_WORD_COUNT
+        stx     VDC_CTRL
+@page:  lda     ptr1+1
+        beq     @tail
+        lda     #VDC_BLOCK_CHUNK
+        vdc_ready
+        sta     VDC_PORT
+        vdc_ready
+        sta     VDC_PORT
+        dec     ptr1+1
+        jmp     @page
+@tail:  lda     ptr1
+        beq     @done
+        vdc_ready
+        sta     VDC_PORT
+@done:  rts
+
+; ------------------------------------------------------------------------
+; VIC-II colour number to VDC RGBI attribute colour, as used by the kernal
+; 80-column editor.
+
+.rodata
+
+_vdc_rgbi:
+        .byte   $00, $0F, $08, $07, $0B, $04, $02, $0D
+        .byte   $0A, $0C, $09, $06, $01, $05, $03, $0E
@@ -11,53 +11,259 @@
 #include <conio.h>
 #include <c128.h>
 #include <peekpoke.h>
+#include "vdc_info_screen.h"
+#include "vdc_fast.h"
+#include "cycle_timer.h"
+#include "warm_state.h"
+#include "profile.h"
+#include "redraw.h"
+#include "display.h"
+#include "ui_strings.h"
 
 // VDC register numbers
-#define VDC_REG_MEMORY_MODE 28
 #define VDC_REG_HIGH_ADDR   18
 #define VDC_REG_LOW_ADDR    19
+#define VDC_REG_MEMORY_MODE 28
 #define VDC_REG_DATA        31
 
-// Write to a VDC register
-void vdc_write(unsigned char reg, unsigned char value) {
-    VDC.ctrl = reg;
-    while (!(VDC.ctrl & 0x80));  // Wait for ready
-    VDC.data = value;
+#define VDC_RAM_64K         0x10
+
+#define COLOR_LABEL_WIDTH   10
+
+// Kernal DLCHR: copy the character ROM back into VDC RAM
+#define KERNAL_DLCHR        "jsr $FF62"
+
+#define RAM_TEST_MAX_FAILS  4
+
+static unsigned char ram_test_run;
+static unsigned char ram_test_kb;
+static unsigned int ram_test_errors;
+static unsigned char ram_test_bits;
+static unsigned char ram_test_fail_count;
+static unsigned int ram_test_fail_address[RAM_TEST_MAX_FAILS];
+static unsigned char ram_test_fail_bits[RAM_TEST_MAX_FAILS];
+static unsigned int ram_test_fill_kbs;
+static unsigned int ram_test_copy_kbs;
+static unsigned long ram_test_start;
+
+// The counter is shared with the PROFILE build, so it is never reloaded
+static void cycle_timer_start(void) {
+    cycle_timer_run();
+    ram_test_start = cycle_timer_read();
+}
+
+static unsigned long cycle_timer_stop(void) {
+    return cycle_timer_read() - ram_test_start;
+}
+
+static unsigned int kb_per_second(unsigned char kb, unsigned long cycles) {
+    if (cycles == 0)
+        return 0;
+    return (unsigned int)(kb * CIA_CYCLES_PER_SEC / cycles);
+}
+
+static void record_failure(unsigned int address, unsigned char bits) {
+    if (ram_test_fail_count < RAM_TEST_MAX_FAILS) {
+        ram_test_fail_address[ram_test_fail_count] = address;
+        ram_test_fail_bits[ram_test_fail_count] = bits;
+        ++ram_test_fail_count;
+    }
+    ram_test_bits |= bits;
+    if (ram_test_errors != 0xFFFF)
+        ++ram_test_errors;
+}
+
+/*
+ * Stream a block back through the auto-incrementing data register. Clean
+ * pages take the assembly fast path; only a failing page is read again
+ * byte by byte to locate the bad addresses.
+ */
+static void vdc_verify_block(unsigned int address, unsigned char expected,
+                             unsigned int count) {
+    unsigned char value;
+
+    vdc_set_address(address);
+    if (count == 256 && vdc_verify_run(expected, 0) == 0)
+        return;
+
+    vdc_set_address(address);
+    while (count != 0) {
+        value = vdc_read(VDC_REG_DATA) ^ expected;
+        if (value)
+            record_failure(address, value);
+        ++address;
+        --count;
+    }
+}
+
+/*
+ * One march element over every 256-byte page: verify the previous pattern,
+ * then block fill the next one. Pages are walked up or down so that
+ * coupling faults between pages are caught in both directions.
+ */
+static void march_element(unsigned int pages, unsigned char expected,
+                          unsigned char next, unsigned char descending,
+                          unsigned char write) {
+    unsigned int i;
+    unsigned int address;
+
+    for (i = 0; i < pages; ++i) {
+        address = (descending ? pages - 1 - i : i) << 8;
+        vdc_verify_block(address, expected, 256);
+        if (write)
+            vdc_fill(address, next, 256);
+    }
+}
+
+/*
+ * 64K probe, run in 64K mode: $00 to $1FFF, $FF to $9FFF, then point the
+ * update address back at $1FFF for the read.
+ */
+static const unsigned char ram_probe_regs[] = {
+    VDC_REG_HIGH_ADDR, 0x1F, VDC_REG_LOW_ADDR, 0xFF, VDC_REG_DATA, 0x00,
+    VDC_REG_HIGH_ADDR, 0x9F, VDC_REG_LOW_ADDR, 0xFF, VDC_REG_DATA, 0xFF,
+    VDC_REG_HIGH_ADDR, 0x1F, VDC_REG_LOW_ADDR, 0xFF,
+    VDC_REGS_END
+};
+
+// Probe 16K vs 64K: in 64K mode $9FFF does not alias $1FFF
+static unsigned char detect_vdc_ram_kb(void) {
+    unsigned char oldval, result;
+
+    // Save original register 28
+    oldval = vdc_read(VDC_REG_MEMORY_MODE);
+
+    // Enable 64KB mode
+    vdc_write(VDC_REG_MEMORY_MODE, oldval | VDC_RAM_64K);
+
+    vdc_write_regs(ram_probe_regs);
+    result = vdc_read(VDC_REG_DATA);
+
+    // Restore original register
+    vdc_write(VDC_REG_MEMORY_MODE, oldval);
+
+    return result == 0x00 ? 64 : 16;
 }
 
-// Read from a VDC register
-unsigned char vdc_read(unsigned char reg) {
-    VDC.ctrl = reg;
-    while (!(VDC.ctrl & 0x80));
-    return VDC.data;
+/*
+ * Destructive march test of the whole VDC RAM. Fills and copies use the
+ * VDC block engine, reads use the auto-incrementing data register. The
+ * 64K test runs in 64K addressing mode, which scrambles the kernal's 16K
+ * layout, so the text area and character set are rebuilt afterwards and
+ * the caller must repaint the screen.
+ */
+void run_vdc_ram_test(void) {
+    unsigned char oldval;
+    unsigned int pages;
+    unsigned int half;
+    unsigned int offset;
+    unsigned long cycles;
+
+    ram_test_kb = detect_vdc_ram_kb();
+    warm_state.vdc_ram_kb = ram_test_kb;
+    warm_state_seal();
+    ram_test_errors = 0;
+    ram_test_bits = 0;
+    ram_test_fail_count = 0;
+    pages = (unsigned int)ram_test_kb << 2;
+    half = pages << 7;
+
+    __asm__("sei");
+    oldval = vdc_read(VDC_REG_MEMORY_MODE);
+    if (ram_test_kb == 64)
+        vdc_write(VDC_REG_MEMORY_MODE, oldval | VDC_RAM_64K);
+
+    // Timed background fill; the fill counter is 16 bits, so do two halves
+    cycle_timer_start();
+    vdc_fill(0x0000, 0x00, half);
+    vdc_fill(half, 0x00, half);
+    vdc_wait();
+    cycles = cycle_timer_stop();
+    ram_test_fill_kbs = kb_per_second(ram_test_kb, cycles);
+
+    march_element(pages, 0x00, 0xFF, 0, 1);
+    march_element(pages, 0xFF, 0x55, 1, 1);
+    march_element(pages, 0x55, 0xAA, 0, 1);
+    march_element(pages, 0xAA, 0x00, 1, 0);
+
+    // Timed copy of the lower half over the upper half, then verify it
+    vdc_fill(0x0000, 0x3C, half);
+    cycle_timer_start();
+    vdc_copy(half, 0x0000, half);
+    vdc_wait();
+    cycles = cycle_timer_stop();
+    ram_test_copy_kbs = kb_per_second(ram_test_kb >> 1, cycles);
+    for (offset = 0; offset < half; offset += 256)
+        vdc_verify_block(half + offset, 0x3C, 256);
+
+    // Back to the kernal layout: blank text, attributes and reload charset
+    vdc_write(VDC_REG_MEMORY_MODE, oldval);
+    vdc_fill(VDC_SCREEN_RAM, ' ', VDC_TEXT_RAM_SIZE);
+    vdc_fill(VDC_ATTR_RAM, 0x00, VDC_TEXT_RAM_SIZE);
+    vdc_wait();
+    __asm__(KERNAL_DLCHR);
+    __asm__("cli");
+
+    ram_test_run = 1;
 }
 
-// Draw color bars with names
+static void draw_ram_test_result(unsigned char screen_width) {
+    unsigned char i;
+
+    gotoxy(0, 4);
+    if (!ram_test_run) {
+        textcolor(COLOR_GRAY3);
+        cputs("RETURN: full RAM march test");
+    } else if (ram_test_errors == 0) {
+        textcolor(COLOR_LIGHTGREEN);
+        cprintf("RAM OK  fill %u KB/s  copy %u KB/s",
+                ram_test_fill_kbs, ram_test_copy_kbs);
+    } else {
+        textcolor(COLOR_LIGHTRED);
+        cprintf("RAM FAIL x%u bits $%02X", ram_test_errors, ram_test_bits);
+        for (i = 0; i < ram_test_fail_count &&
+                    wherex() + 9 < screen_width; ++i) {
+            cprintf(" $%04X:%02X", ram_test_fail_address[i],
+                    ram_test_fail_bits[i]);
+        }
+    }
+    textcolor(COLOR_WHITE);
+}
+
+/*
+ * Draw color bars with names. Characters and colours are written straight
+ * into screen and attribute (VDC) or colour (VIC) memory through the display
+ * driver, so the whole block is rendered from the start of one blanking
+ * period instead of through about a thousand conio character calls.
+ */
 void draw_color_test_bar(unsigned char y_offset, unsigned char width) {
-    const char* color_names[16] = {
+    static const char* color_names[16] = {
         "Black", "White", "Red", "Cyan",
         "Purple", "Green", "Blue", "Yellow",
         "Orange", "Brown", "LightRed", "Gray1",
         "Gray2", "LightGreen", "LightBlue", "Gray3"
     };
 
+    unsigned char label[COLOR_LABEL_WIDTH];
     unsigned char i, j;
-    const unsigned char label_width = 9;
-
-    for (i = 0; i < 16; ++i) {
-        unsigned char y = y_offset + i;
+    unsigned char bar_width = width - COLOR_LABEL_WIDTH;
+    unsigned int row;
+    const char* name;
 
-        gotoxy(0, y);
-        textcolor(COLOR_WHITE);
-        revers(0);
-        cprintf("%-10s", color_names[i]);
+    display->wait_blank();
 
-        textcolor(i);
-        revers(1);
-        for (j = 0; j < width - label_width - 1; ++j) {
-            cputc(' ');
+    for (i = 0; i < 16; ++i) {
+        name = color_names[i];
+        for (j = 0; j < COLOR_LABEL_WIDTH; ++j) {
+            label[j] = *name ? display_screen_code(*name++) : DISPLAY_SPACE;
         }
-        revers(0);
+
+        row = display->row_offset[y_offset + i];
+        display->put_span(row, label, COLOR_LABEL_WIDTH);
+        display->set_colour(row, COLOR_WHITE, COLOR_LABEL_WIDTH);
+        display->fill(row + COLOR_LABEL_WIDTH, DISPLAY_SPACE | DISPLAY_REVERSE,
+                      bar_width);
+        display->set_colour(row + COLOR_LABEL_WIDTH, i, bar_width);
     }
 
     textcolor(COLOR_WHITE);
@@ -65,52 +271,45 @@ void draw_color_test_bar(unsigned char y_offset, unsigned char width) {
 
 // Main VDC info screen
 void draw_vdc_info_screen(unsigned char screen_width) {
-    unsigned char oldval, result, i;
+    unsigned char i;
 
+    PROFILE_ENTER(PROF_DRAW_VDC_INFO);
+    redraw_begin();
     for (i = 3; i < 23; i++) {
         cclearxy(0, i, screen_width);
     }
 
     textcolor(COLOR_CYAN);
-    cputsxy((screen_width - 20) / 2, 2, "VDC RAM Test Utility");
-
-    // Save original register 28
-    oldval = vdc_read(VDC_REG_MEMORY_MODE);
-
-    // Enable 64KB mode
-    vdc_write(VDC_REG_MEMORY_MODE, oldval | 0x10);
-
-    // Write 0x00 to $1FFF
-    vdc_write(VDC_REG_HIGH_ADDR, 0x1F);
-    vdc_write(VDC_REG_LOW_ADDR, 0xFF);
-    vdc_write(VDC_REG_DATA, 0x00);
-
-    // Write 0xFF to $9FFF
-    vdc_write(VDC_REG_HIGH_ADDR, 0x9F);
-    vdc_write(VDC_REG_LOW_ADDR, 0xFF);
-    vdc_write(VDC_REG_DATA, 0xFF);
-
-    // Read back from $1FFF
-    vdc_write(VDC_REG_HIGH_ADDR, 0x1F);
-    vdc_write(VDC_REG_LOW_ADDR, 0xFF);
-    result = vdc_read(VDC_REG_DATA);
-
-    // Restore original register
-    vdc_write(VDC_REG_MEMORY_MODE, oldval);
+    ui_putsxy((screen_width - 20) / 2, 2, UI_VDC_TITLE);
 
     // Show result
     textcolor(COLOR_WHITE);
-    if (result == 0x00) {
-        cputsxy(0, 3, "Detected VDC RAM: 64 KB");
+    // Probe once per power-on; later visits and resets reuse the result
+    if (warm_state.vdc_ram_kb == 0) {
+        warm_state.vdc_ram_kb = detect_vdc_ram_kb();
+        warm_state_seal();
+    }
+    if (warm_state.vdc_ram_kb == 64) {
+        ui_putsxy(0, 3, UI_VDC_RAM_64K);
     } else {
-        cputsxy(0, 3, "Detected VDC RAM: 16 KB");
+        ui_putsxy(0, 3, UI_VDC_RAM_16K);
     }
+    draw_ram_test_result(screen_width);
 
     if (screen_width == 80) {
-        cputsxy(10, 5, "VDC Available Colors:");
+        ui_putsxy(10, 5, UI_VDC_COLORS_VDC);
     } else {
-        cputsxy(10, 5, "VIC-II Available Colors:");
+        ui_putsxy(10, 5, UI_VDC_COLORS_VIC);
     }
 
     draw_color_test_bar(6, screen_width);
-}
\ No newline at end of file
+    redraw_end();
+    PROFILE_LEAVE(PROF_DRAW_VDC_INFO);
+}
+
+void draw_vdc_ram_test_busy(unsigned char screen_width) {
+    cclearxy(0, 4, screen_width);
+    textcolor(COLOR_YELLOW);
+    ui_putsxy(0, 4, UI_VDC_TESTING);
+    textcolor(COLOR_WHITE);
+}
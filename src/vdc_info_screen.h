@@ -2,5 +2,7 @@
 #define VDC_INFO_SCREEN_H
 
 void draw_vdc_info_screen(unsigned char screen_width);
+void draw_vdc_ram_test_busy(unsigned char screen_width);
+void run_vdc_ram_test(void);
 
 #endif
@@ -0,0 +1,55 @@
+//   _____  ___________              _______________
+//   __  / / /__  /_  /_____________ __|__  /_  ___/
+//   _  / / /__  /_  __/_  ___/  __ `/__/_ <_  __ \
+//   / /_/ / _  / / /_ _  /   / /_/ /____/ // /_/ /
+//   \____/  /_/  \__/ /_/    \__,_/ /____/ \____/
+// Ultra-36 Rom Switcher for Commodore 128 - C128 Menu Program
+// Free for personal use.
+// Commercial use or resale (in whole or part) prohibited without permission.
+// (c) 2025 Lukasz Dziwosz / LukasSoft. All Rights Reserved.
+
+#include <string.h>
+#include "warm_state.h"
+
+static unsigned int warm_state_sum(void)
+{
+    const unsigned char *byte;
+    unsigned int sum = 0;
+
+    for (byte = (const unsigned char *)&warm_state.version;
+         byte != (const unsigned char *)&warm_state.checksum;
+         ++byte)
+        sum += *byte;
+    return ~sum;
+}
+
+void warm_state_seal(void)
+{
+    warm_state.checksum = warm_state_sum();
+}
+
+unsigned char warm_state_restore(unsigned char rom_count)
+{
+    if (warm_state.magic[0] == WARM_STATE_MAGIC0 &&
+        warm_state.magic[1] == WARM_STATE_MAGIC1 &&
+        warm_state.magic[2] == WARM_STATE_MAGIC2 &&
+        warm_state.magic[3] == WARM_STATE_MAGIC3 &&
+        warm_state.version == WARM_STATE_VERSION &&
+        warm_state.checksum == warm_state_sum() &&
+        warm_state.rom_count == rom_count &&
+        warm_state.rom_selected < rom_count &&
+        warm_state.jiffy_selected < 2 &&
+        warm_state.screen < 3)
+        return 1;
+
+    memset(&warm_state, 0, sizeof(warm_state));
+    warm_state.magic[0] = WARM_STATE_MAGIC0;
+    warm_state.magic[1] = WARM_STATE_MAGIC1;
+    warm_state.magic[2] = WARM_STATE_MAGIC2;
+    warm_state.magic[3] = WARM_STATE_MAGIC3;
+    warm_state.version = WARM_STATE_VERSION;
+    warm_state.rom_count = rom_count;
+    warm_state.ack_steps = WARM_ACK_UNKNOWN;
+    warm_state_seal();
+    return 0;
+}
@@ -0,0 +1,41 @@
+#ifndef WARM_STATE_H
+#define WARM_STATE_H
+
+/*
+ * Menu state kept across resets in the $1300-$17FF application area, which
+ * the kernal reset leaves alone and this program (RAM from $1C00) never
+ * uses. Power-on garbage or a block from another ROM set fails the
+ * magic/version/checksum test and is replaced by defaults.
+ */
+#define WARM_STATE_ADDR         0x1300
+#define WARM_STATE_MAGIC0       'U'
+#define WARM_STATE_MAGIC1       '3'
+#define WARM_STATE_MAGIC2       '6'
+#define WARM_STATE_MAGIC3       'W'
+#define WARM_STATE_VERSION      1
+#define WARM_ACK_UNKNOWN        0xFFFF
+
+struct warm_state {
+    char magic[4];
+    unsigned char version;
+    unsigned char rom_count;            // Menu entries rom_selected refers to
+    unsigned char rom_selected;         // romNames index
+    unsigned char jiffy_selected;
+    unsigned char screen;               // 0=ROM, 1=JiffyDOS, 2=Info
+    unsigned char sid1_model;           // SID_6581/8580/UNKNOWN, 0 = not probed
+    unsigned char sid2_selected;
+    unsigned char vdc_ram_kb;           // 16 or 64, 0 = not probed
+    unsigned int ack_steps;             // Last Ultra-36 acknowledge latency
+    unsigned int checksum;              // ~16-bit sum of version..ack_steps
+};
+
+#define warm_state (*(struct warm_state *)WARM_STATE_ADDR)
+
+// Keeps a valid block saved for a menu with rom_count entries, otherwise
+// resets it to defaults with nothing probed. Returns 1 if it was kept.
+unsigned char warm_state_restore(unsigned char rom_count);
+
+// Recomputes the checksum; call after changing any field
+void warm_state_seal(void);
+
+#endif
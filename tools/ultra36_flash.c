@@ -0,0 +1,707 @@
+//   _____  ___________              _______________
+//   __  / / /__  /_  /_____________ __|__  /_  ___/
+//   _  / / /__  /_  __/_  ___/  __ `/__/_ <_  __ \
+//   / /_/ / _  / / /_ _  /   / /_/ /____/ // /_/ /
+//   \____/  /_/  \__/ /_/    \__,_/ /____/ \____/
+// Ultra-36 Rom Switcher for Commodore 128 - Flash image assembler (host tool)
+// Free for personal use.
+// Commercial use or resale (in whole or part) prohibited without permission.
+// (c) 2025 Lukasz Dziwosz / LukasSoft. All Rights Reserved.
+//
+// Streams the menu bank, the generated Empty_Bank and the user ROM images
+// into one SST39SF020A (8 x 32K), SST39SF040 (16 x 32K) or larger 32 or
+// 64 bank flash image.
+// 16K images are padded to a full bank, or with -p packed two to a bank
+// (lower and upper half, selected by the half-bank command). Alongside the
+// image it writes a
+// manifest with per-bank CRC-32 and SHA-256 values, a sha256sum file and
+// the matching USER_ROM_NAMES_INIT header for the menu build. With -C it
+// also describes every selectable bank (size, autostart byte, CBM
+// signature, CRC-32, description) in src/rom_catalog_data.h, which the
+// menu build stores in HIRODATA.
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#define BANK_SIZE 0x8000
+#define HALF_BANK_SIZE 0x4000
+#define MAX_BANKS 64
+#define MAX_USER_ROMS 62                // Name table capacity (name_table.h)
+#define MAX_NAME_LENGTH 16
+#define MAX_DESCRIPTION_LENGTH 16
+#define CART_MODE_OFFSET 6
+#define CBM_SIGNATURE_OFFSET 7
+#define FILL_BYTE 0xFF
+#define EMPTY_BANK_NAME "Empty_Bank"
+#define MENU_BANK_NAME "Ultra-36_Menu"
+
+// Half of a bank a ROM occupies; also bits 6-7 of its name table slot
+#define HALF_FULL 0
+#define HALF_LOWER 1
+#define HALF_UPPER 2
+
+struct rom_input
+{
+    char name[MAX_NAME_LENGTH + 1];
+    char description[MAX_DESCRIPTION_LENGTH + 1];
+    const char *path;
+    const uint8_t *data;
+    size_t size;
+    unsigned int bank;
+    unsigned int half;
+};
+
+struct sha256
+{
+    uint32_t state[8];
+    uint64_t length;
+    uint8_t block[64];
+    size_t used;
+};
+
+static const char *program_name = "ultra36-flash";
+
+static void fail(const char *format, const char *detail)
+{
+    fprintf(stderr, "%s: ", program_name);
+    fprintf(stderr, format, detail);
+    fputc('\n', stderr);
+    exit(1);
+}
+
+static void usage(void)
+{
+    fprintf(stderr,
+            "usage: %s -b 8|16|32|64 [-p] [-m MENU.bin -o IMAGE.bin] [-H NAMES.h] "
+            "[-C CATALOG.h] NAME=ROM.bin[:Description]...\n"
+            "  -b  total number of 32K banks (8: SST39SF020A, 16: SST39SF040,\n"
+            "      32/64: 1MB/2MB parts)\n"
+            "  -p  pack 16K ROMs two to a bank; up to 62 ROMs in any "
+            "number of banks\n"
+            "  -m  32K menu bank (build/ultra36_32.bin)\n"
+            "  -o  flash image to write; IMAGE.manifest and IMAGE.sha256 "
+            "are written next to it\n"
+            "  -H  header with NUM_USER_ROMS and USER_ROM_NAMES_INIT "
+            "(default: IMAGE.names.h)\n"
+            "  -C  write the per-bank ROM catalog header for the menu build\n"
+            "User ROMs fill banks 2 and up in order; without -p 16K images "
+            "are padded to 32K.\n",
+            program_name);
+    exit(2);
+}
+
+/* ---- CRC-32 (IEEE 802.3) ---------------------------------------------- */
+
+static uint32_t crc_table[256];
+
+static void crc32_init(void)
+{
+    uint32_t value;
+    unsigned int i;
+    unsigned int bit;
+
+    for (i = 0; i < 256; i++)
+    {
+        value = i;
+        for (bit = 0; bit < 8; bit++)
+            value = (value & 1) ? (value >> 1) ^ 0xEDB88320u : value >> 1;
+        crc_table[i] = value;
+    }
+}
+
+static uint32_t crc32_update(uint32_t crc, const uint8_t *data, size_t size)
+{
+    crc ^= 0xFFFFFFFFu;
+    while (size--)
+        crc = crc_table[(crc ^ *data++) & 0xFF] ^ (crc >> 8);
+    return crc ^ 0xFFFFFFFFu;
+}
+
+static uint32_t crc32(const uint8_t *data, size_t size)
+{
+    return crc32_update(0, data, size);
+}
+
+// CRC-32 of a ROM as it sits in its bank, padding included
+static uint32_t bank_crc32(const uint8_t *data, size_t size)
+{
+    static uint8_t padding[BANK_SIZE];
+    uint32_t crc = crc32_update(0, data, size);
+
+    if (size == BANK_SIZE)
+        return crc;
+    memset(padding, FILL_BYTE, BANK_SIZE - size);
+    return crc32_update(crc, padding, BANK_SIZE - size);
+}
+
+/* ---- SHA-256 (FIPS 180-4) --------------------------------------------- */
+
+static const uint32_t sha256_k[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1,
+    0x923f82a4, 0xab1c5ed5, 0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3,
+    0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174, 0xe49b69c1, 0xefbe4786,
+    0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147,
+    0x06ca6351, 0x14292967, 0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13,
+    0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85, 0xa2bfe8a1, 0xa81a664b,
+    0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a,
+    0x5b9cca4f, 0x682e6ff3, 0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208,
+    0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2};
+
+#define ROTR(x, n) (((x) >> (n)) | ((x) << (32 - (n))))
+
+static void sha256_block(struct sha256 *ctx, const uint8_t *block)
+{
+    uint32_t w[64];
+    uint32_t a, b, c, d, e, f, g, h;
+    uint32_t t1, t2;
+    unsigned int i;
+
+    for (i = 0; i < 16; i++)
+        w[i] = ((uint32_t)block[i * 4] << 24) |
+               ((uint32_t)block[i * 4 + 1] << 16) |
+               ((uint32_t)block[i * 4 + 2] << 8) | block[i * 4 + 3];
+    for (i = 16; i < 64; i++)
+        w[i] = w[i - 16] + w[i - 7] +
+               (ROTR(w[i - 15], 7) ^ ROTR(w[i - 15], 18) ^ (w[i - 15] >> 3)) +
+               (ROTR(w[i - 2], 17) ^ ROTR(w[i - 2], 19) ^ (w[i - 2] >> 10));
+
+    a = ctx->state[0];
+    b = ctx->state[1];
+    c = ctx->state[2];
+    d = ctx->state[3];
+    e = ctx->state[4];
+    f = ctx->state[5];
+    g = ctx->state[6];
+    h = ctx->state[7];
+
+    for (i = 0; i < 64; i++)
+    {
+        t1 = h + (ROTR(e, 6) ^ ROTR(e, 11) ^ ROTR(e, 25)) +
+             ((e & f) ^ (~e & g)) + sha256_k[i] + w[i];
+        t2 = (ROTR(a, 2) ^ ROTR(a, 13) ^ ROTR(a, 22)) +
+             ((a & b) ^ (a & c) ^ (b & c));
+        h = g;
+        g = f;
+        f = e;
+        e = d + t1;
+        d = c;
+        c = b;
+        b = a;
+        a = t1 + t2;
+    }
+
+    ctx->state[0] += a;
+    ctx->state[1] += b;
+    ctx->state[2] += c;
+    ctx->state[3] += d;
+    ctx->state[4] += e;
+    ctx->state[5] += f;
+    ctx->state[6] += g;
+    ctx->state[7] += h;
+}
+
+static void sha256_init(struct sha256 *ctx)
+{
+    static const uint32_t initial[8] = {
+        0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
+        0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19};
+
+    memcpy(ctx->state, initial, sizeof(initial));
+    ctx->length = 0;
+    ctx->used = 0;
+}
+
+static void sha256_update(struct sha256 *ctx, const uint8_t *data, size_t size)
+{
+    size_t take;
+
+    ctx->length += size;
+    while (size != 0)
+    {
+        if (ctx->used == 0 && size >= 64)
+        {
+            sha256_block(ctx, data);
+            data += 64;
+            size -= 64;
+            continue;
+        }
+        take = 64 - ctx->used;
+        if (take > size)
+            take = size;
+        memcpy(ctx->block + ctx->used, data, take);
+        ctx->used += take;
+        data += take;
+        size -= take;
+        if (ctx->used == 64)
+        {
+            sha256_block(ctx, ctx->block);
+            ctx->used = 0;
+        }
+    }
+}
+
+static void sha256_final(struct sha256 *ctx, char hex[65])
+{
+    uint64_t bits = ctx->length * 8;
+    unsigned int i;
+
+    ctx->block[ctx->used++] = 0x80;
+    if (ctx->used > 56)
+    {
+        memset(ctx->block + ctx->used, 0, 64 - ctx->used);
+        sha256_block(ctx, ctx->block);
+        ctx->used = 0;
+    }
+    memset(ctx->block + ctx->used, 0, 56 - ctx->used);
+    for (i = 0; i < 8; i++)
+        ctx->block[56 + i] = (uint8_t)(bits >> (56 - i * 8));
+    sha256_block(ctx, ctx->block);
+
+    for (i = 0; i < 8; i++)
+        sprintf(hex + i * 8, "%08x", (unsigned int)ctx->state[i]);
+}
+
+static void sha256_hex(const uint8_t *data, size_t size, char hex[65])
+{
+    struct sha256 ctx;
+
+    sha256_init(&ctx);
+    sha256_update(&ctx, data, size);
+    sha256_final(&ctx, hex);
+}
+
+/* ---- Inputs ----------------------------------------------------------- */
+
+static const uint8_t *map_file(const char *path, size_t *size)
+{
+    struct stat info;
+    void *data;
+    int fd;
+
+    fd = open(path, O_RDONLY);
+    if (fd < 0)
+        fail("cannot open %s", path);
+    if (fstat(fd, &info) != 0 || info.st_size == 0)
+        fail("cannot read %s", path);
+
+    data = mmap(NULL, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED)
+        fail("cannot map %s", path);
+
+    *size = (size_t)info.st_size;
+    return data;
+}
+
+// Same rules as scripts/generate_online_config.py; quotes would break the
+// generated C headers.
+static void copy_label(char *dest, const char *start, size_t length,
+                       size_t max_length, const char *argument)
+{
+    size_t i;
+
+    if (length > max_length)
+        fail("label exceeds 16 characters in '%s'", argument);
+    for (i = 0; i < length; i++)
+    {
+        if (start[i] < 32 || start[i] > 126 || start[i] == '"' ||
+            start[i] == '\\')
+            fail("labels must be printable ASCII without quotes in '%s'",
+                 argument);
+        dest[i] = start[i];
+    }
+    dest[length] = '\0';
+}
+
+static void parse_rom_argument(struct rom_input *rom, const char *argument)
+{
+    const char *separator = strchr(argument, '=');
+    const char *description;
+    static char path[4096];
+    size_t length;
+
+    if (separator == NULL)
+        fail("expected NAME=ROM.bin, got '%s'", argument);
+
+    length = (size_t)(separator - argument);
+    if (length == 0)
+        fail("empty ROM name in '%s'", argument);
+    copy_label(rom->name, argument, length, MAX_NAME_LENGTH, argument);
+
+    description = strchr(separator + 1, ':');
+    if (description == NULL)
+    {
+        rom->description[0] = '\0';
+        rom->path = separator + 1;
+    }
+    else
+    {
+        copy_label(rom->description, description + 1, strlen(description + 1),
+                   MAX_DESCRIPTION_LENGTH, argument);
+        length = (size_t)(description - separator - 1);
+        if (length >= sizeof(path))
+            fail("path too long in '%s'", argument);
+        memcpy(path, separator + 1, length);
+        path[length] = '\0';
+        rom->path = strdup(path);
+    }
+    rom->data = map_file(rom->path, &rom->size);
+    if (rom->size != HALF_BANK_SIZE && rom->size != BANK_SIZE)
+        fail("%s is not a 16K or 32K ROM image", rom->path);
+}
+
+/* ---- Outputs ---------------------------------------------------------- */
+
+static char *with_suffix(const char *path, const char *suffix)
+{
+    char *result = malloc(strlen(path) + strlen(suffix) + 1);
+
+    if (result == NULL)
+        fail("%s", "out of memory");
+    strcpy(result, path);
+    strcat(result, suffix);
+    return result;
+}
+
+static FILE *create_text(const char *path)
+{
+    FILE *file = fopen(path, "w");
+
+    if (file == NULL)
+        fail("cannot create %s", path);
+    return file;
+}
+
+static void close_text(FILE *file, const char *path)
+{
+    if (fclose(file) != 0)
+        fail("cannot write %s", path);
+}
+
+// Same layout as scripts/generate_online_config.py, usable as
+// src/online_rom_config.h for a DEFS=-DONLINE_BUILD menu build.
+static void write_names_header(const char *path, const struct rom_input *roms,
+                               unsigned int count, int packed)
+{
+    FILE *file = create_text(path);
+    unsigned int i;
+
+    fprintf(file,
+            "/* Generated file. Do not edit or commit. */\n"
+            "#ifndef ONLINE_ROM_CONFIG_H\n"
+            "#define ONLINE_ROM_CONFIG_H\n\n"
+            "#define NUM_USER_ROMS %u\n"
+            "#define USER_ROM_NAMES_INIT ",
+            count);
+    for (i = 0; i < count; i++)
+        fprintf(file, "%s\"%s\"", i ? ", " : "", roms[i].name);
+
+    // Bank and half of every entry; unpacked builds use the default layout
+    if (packed)
+    {
+        fprintf(file, "\n#define USER_ROM_SLOTS_INIT ");
+        for (i = 0; i < count; i++)
+            fprintf(file, "%s0x%02X", i ? ", " : "",
+                    roms[i].bank | roms[i].half << 6);
+    }
+    fprintf(file, "\n\n#endif\n");
+    close_text(file, path);
+}
+
+// Catalog of the selectable banks (Empty_Bank first), in menu order
+static void write_catalog_header(const char *path, const struct rom_input *roms,
+                                 unsigned int count)
+{
+    FILE *file = create_text(path);
+    const uint8_t *data;
+    unsigned int flags;
+    unsigned int i;
+
+    fprintf(file,
+            "/* Generated by ultra36-flash. Do not edit or commit. */\n"
+            "#ifndef ROM_CATALOG_DATA_H\n"
+            "#define ROM_CATALOG_DATA_H\n\n"
+            "#define ROM_CATALOG_COUNT %u\n"
+            "#define ROM_CATALOG_INIT \\\n"
+            "    {ROM_CAT_EMPTY, 0x%02X, 0x%08XUL, \"\"}",
+            count + 1, FILL_BYTE,
+            (unsigned int)bank_crc32((const uint8_t *)"", 0));
+    for (i = 0; i < count; i++)
+    {
+        data = roms[i].data;
+        flags = roms[i].size == BANK_SIZE ? 0x01 : 0x00;
+        if (memcmp(data + CBM_SIGNATURE_OFFSET, "CBM", 3) == 0)
+            flags |= 0x02;
+        // A packed half is checked on its own, without padding
+        fprintf(file, ", \\\n    {%s%s%s%s, 0x%02X, 0x%08XUL, \"%s\"}",
+                flags & 0x01 ? "ROM_CAT_32K" : "",
+                flags == 0x03 ? " | " : "",
+                flags & 0x02 ? "ROM_CAT_CBM" : (flags || roms[i].half ? "" : "0"),
+                roms[i].half ? (flags ? " | ROM_CAT_HALF" : "ROM_CAT_HALF") : "",
+                data[CART_MODE_OFFSET],
+                (unsigned int)(roms[i].half ? crc32(data, roms[i].size)
+                                            : bank_crc32(data, roms[i].size)),
+                roms[i].description);
+    }
+    fprintf(file, "\n\n#endif\n");
+    close_text(file, path);
+}
+
+static double elapsed_ms(const struct timespec *start)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (now.tv_sec - start->tv_sec) * 1000.0 +
+           (now.tv_nsec - start->tv_nsec) / 1000000.0;
+}
+
+/* Gives every ROM its bank and half. Unpacked, ROM n owns bank n + 2.
+ * Packed, a 32K ROM takes the next free bank and a 16K ROM fills the upper
+ * half of the last half-used bank or starts a new one. Returns the number
+ * of banks used, including the menu and Empty_Bank. */
+static unsigned int assign_banks(struct rom_input *roms, unsigned int count,
+                                 int packed)
+{
+    unsigned int next_bank = 2;
+    unsigned int open_bank = 0;
+    unsigned int i;
+
+    for (i = 0; i < count; i++)
+    {
+        if (packed && roms[i].size == HALF_BANK_SIZE && open_bank != 0)
+        {
+            roms[i].bank = open_bank;
+            roms[i].half = HALF_UPPER;
+            open_bank = 0;
+            continue;
+        }
+
+        roms[i].bank = next_bank++;
+        roms[i].half = HALF_FULL;
+        if (packed && roms[i].size == HALF_BANK_SIZE)
+        {
+            roms[i].half = HALF_LOWER;
+            open_bank = roms[i].bank;
+        }
+    }
+    return next_bank;
+}
+
+// Manifest columns for one bank: size, name(s) and source(s)
+static void describe_bank(FILE *manifest, const struct rom_input *roms,
+                          unsigned int count, unsigned int bank)
+{
+    const struct rom_input *lower = NULL;
+    const struct rom_input *upper = NULL;
+    unsigned int i;
+
+    for (i = 0; i < count; i++)
+    {
+        if (roms[i].bank != bank)
+            continue;
+        if (roms[i].half == HALF_UPPER)
+            upper = &roms[i];
+        else
+            lower = &roms[i];
+    }
+
+    if (lower == NULL)
+        fprintf(manifest, "unused\n");
+    else if (lower->half == HALF_FULL)
+        fprintf(manifest, "%s %s %s\n",
+                lower->size == BANK_SIZE ? "32K" : "16K+pad", lower->name,
+                lower->path);
+    else if (upper == NULL)
+        fprintf(manifest, "16K|pad %s|- %s|-\n", lower->name, lower->path);
+    else
+        fprintf(manifest, "16K|16K %s|%s %s|%s\n", lower->name, upper->name,
+                lower->path, upper->path);
+}
+
+// Map the output, stream every bank straight into it and describe it
+static void write_image(const char *image_path, const char *menu_path,
+                        const struct rom_input *roms, unsigned int rom_count,
+                        unsigned int bank_count, char image_sha[65])
+{
+    const uint8_t *menu;
+    size_t menu_size;
+    size_t image_size;
+    unsigned int bank;
+    unsigned int i;
+    uint8_t *image;
+    uint8_t *slot;
+    char bank_sha[65];
+    char *manifest_path;
+    char *sha_path;
+    FILE *manifest;
+    FILE *sha_file;
+    int fd;
+
+    menu = map_file(menu_path, &menu_size);
+    if (menu_size != BANK_SIZE)
+        fail("%s is not a 32K menu bank (build with CARTTYPE=cart128_32)",
+             menu_path);
+
+    image_size = (size_t)bank_count * BANK_SIZE;
+    fd = open(image_path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0)
+        fail("cannot create %s", image_path);
+    if (ftruncate(fd, (off_t)image_size) != 0)
+        fail("cannot size %s", image_path);
+    image = mmap(NULL, image_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (image == MAP_FAILED)
+        fail("cannot map %s", image_path);
+    close(fd);
+
+    // Empty_Bank, padding and unused banks are all erased flash
+    memcpy(image, menu, BANK_SIZE);
+    memset(image + BANK_SIZE, FILL_BYTE, image_size - BANK_SIZE);
+    for (i = 0; i < rom_count; i++)
+    {
+        slot = image + (size_t)roms[i].bank * BANK_SIZE;
+        if (roms[i].half == HALF_UPPER)
+            slot += HALF_BANK_SIZE;
+        memcpy(slot, roms[i].data, roms[i].size);
+    }
+
+    sha256_hex(image, image_size, image_sha);
+
+    manifest_path = with_suffix(image_path, ".manifest");
+    manifest = create_text(manifest_path);
+    fprintf(manifest, "# Ultra-36 flash image manifest\n");
+    fprintf(manifest, "image %s size %zu banks %u sha256 %s\n",
+            image_path, image_size, bank_count, image_sha);
+    fprintf(manifest, "# bank crc32 sha256 size name source\n");
+    for (bank = 0; bank < bank_count; bank++)
+    {
+        slot = image + (size_t)bank * BANK_SIZE;
+        sha256_hex(slot, BANK_SIZE, bank_sha);
+        fprintf(manifest, "bank %2u %08x %s ", bank,
+                (unsigned int)crc32(slot, BANK_SIZE), bank_sha);
+        if (bank == 0)
+            fprintf(manifest, "32K %s %s\n", MENU_BANK_NAME, menu_path);
+        else if (bank == 1)
+            fprintf(manifest, "32K %s (generated)\n", EMPTY_BANK_NAME);
+        else
+            describe_bank(manifest, roms, rom_count, bank);
+    }
+    close_text(manifest, manifest_path);
+
+    sha_path = with_suffix(image_path, ".sha256");
+    sha_file = create_text(sha_path);
+    fprintf(sha_file, "%s  %s\n", image_sha, image_path);
+    close_text(sha_file, sha_path);
+
+    if (msync(image, image_size, MS_SYNC) != 0)
+        fail("cannot write %s", image_path);
+    munmap(image, image_size);
+}
+
+int main(int argc, char **argv)
+{
+    struct rom_input roms[MAX_USER_ROMS];
+    struct timespec start;
+    const char *image_path = NULL;
+    const char *menu_path = NULL;
+    const char *header_path = NULL;
+    const char *catalog_path = NULL;
+    unsigned int bank_count = 0;
+    unsigned int rom_count;
+    unsigned int banks_used;
+    int packed = 0;
+    char image_sha[65];
+    int option;
+    int i;
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+
+    while ((option = getopt(argc, argv, "b:pm:o:H:C:h")) != -1)
+    {
+        switch (option)
+        {
+        case 'b':
+            bank_count = (unsigned int)atoi(optarg);
+            break;
+        case 'p':
+            packed = 1;
+            break;
+        case 'm':
+            menu_path = optarg;
+            break;
+        case 'o':
+            image_path = optarg;
+            break;
+        case 'H':
+            header_path = optarg;
+            break;
+        case 'C':
+            catalog_path = optarg;
+            break;
+        default:
+            usage();
+        }
+    }
+
+    // Without an image only the headers for the menu build are written
+    if ((menu_path == NULL) != (image_path == NULL))
+        usage();
+    if (image_path == NULL && catalog_path == NULL && header_path == NULL)
+        usage();
+    if (bank_count != 8 && bank_count != 16 && bank_count != 32 &&
+        bank_count != 64)
+        fail("%s", "bank count must be 8 (SST39SF020A), 16 (SST39SF040), 32 "
+                   "or 64");
+
+    rom_count = (unsigned int)(argc - optind);
+    if (!packed && rom_count != bank_count - 2)
+    {
+        fprintf(stderr, "%s: %u banks require exactly %u user ROMs, got %u\n",
+                program_name, bank_count, bank_count - 2, rom_count);
+        return 1;
+    }
+    if (packed && (rom_count == 0 || rom_count > MAX_USER_ROMS))
+    {
+        fprintf(stderr, "%s: packing takes 1 to %u user ROMs, got %u\n",
+                program_name, MAX_USER_ROMS, rom_count);
+        return 1;
+    }
+
+    for (i = 0; i < (int)rom_count; i++)
+        parse_rom_argument(&roms[i], argv[optind + i]);
+    banks_used = assign_banks(roms, rom_count, packed);
+    if (banks_used > bank_count)
+    {
+        fprintf(stderr, "%s: the ROMs need %u banks, the image has %u\n",
+                program_name, banks_used, bank_count);
+        return 1;
+    }
+    crc32_init();
+
+    if (catalog_path != NULL)
+        write_catalog_header(catalog_path, roms, rom_count);
+    if (header_path == NULL && image_path != NULL)
+        header_path = with_suffix(image_path, ".names.h");
+    if (header_path != NULL)
+        write_names_header(header_path, roms, rom_count, packed);
+    if (image_path == NULL)
+        return 0;
+
+    write_image(image_path, menu_path, roms, rom_count, bank_count, image_sha);
+    printf("%s: %u banks, %zu bytes, sha256 %s (%.2f ms)\n", image_path,
+           bank_count, (size_t)bank_count * BANK_SIZE, image_sha,
+           elapsed_ms(&start));
+    return 0;
+}
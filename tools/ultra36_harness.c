@@ -0,0 +1,1896 @@
+//   _____  ___________              _______________
+//   __  / / /__  /_  /_____________ __|__  /_  ___/
+//   _  / / /__  /_  __/_  ___/  __ `/__/_ <_  __ \
+//   / /_/ / _  / / /_ _  /   / /_/ /____/ // /_/ /
+//   \____/  /_/  \__/ /_/    \__,_/ /____/ \____/
+// Ultra-36 Rom Switcher for Commodore 128 - Headless test harness (host tool)
+// Free for personal use.
+// Commercial use or resale (in whole or part) prohibited without permission.
+// (c) 2025 Lukasz Dziwosz / LukasSoft. All Rights Reserved.
+//
+// Runs the 32K menu ROM on a minimal C128: an 8502 core (NMOS 6502 plus the
+// $00/$01 port and 2 MHz mode), the MMU at $D500/$FF00, VIC-II raster and
+// IRQ, CIA1 keyboard and timers, CIA2 User Port and timers, the VDC register
+// port with 64K of RAM, and SID register writes. The kernal image is the
+// user's own (VICE ships it); with BASIC images as well the machine boots
+// from the reset vector, otherwise the menu is entered at $8000 directly,
+// which runs its own RESTOR/IOINIT/CINT.
+//
+// A script feeds keystrokes through the keyboard matrix and reports cycles
+// and frames from each key press until the menu polls an empty keyboard
+// buffer again. The User Port bitstream is decoded and acknowledged the way
+// the ATtiny on the Ultra-36 board does it, and can be traced as a VCD file
+// for scripts/analyze_link.py.
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <ctype.h>
+#include <stdarg.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#define ROM_SIZE 0x8000
+#define HALF_ROM_SIZE 0x4000
+#define CHARGEN_SIZE 0x2000
+
+// PAL timing in 1 MHz ticks; the CPU runs two cycles per tick in FAST mode
+#define TICKS_PER_LINE 63
+#define LINES_PER_FRAME 312
+#define TICKS_PER_FRAME (TICKS_PER_LINE * LINES_PER_FRAME)
+#define VBLANK_FIRST_LINE 251
+#define VBLANK_LAST_LINE 15
+
+#define FLAG_C 0x01
+#define FLAG_Z 0x02
+#define FLAG_I 0x04
+#define FLAG_D 0x08
+#define FLAG_B 0x10
+#define FLAG_U 0x20
+#define FLAG_V 0x40
+#define FLAG_N 0x80
+
+#define KEY_COUNT 0x00D0        // Kernal NDX, polled by cc65's cgetc()
+#define EDITOR_MODE 0x00D7      // Bit 7 set: 80-column editor active
+
+#define KEY_HOLD_FRAMES 3
+#define DEFAULT_IDLE_FRAMES 600
+#define MAX_INTERACTIONS 64
+#define MAX_SERIAL_BYTES 64
+
+// Ultra-36 User Port wiring and ATtiny acknowledge timing (1 MHz ticks)
+#define SERIAL_DATA_MASK 0x01
+#define SERIAL_CLOCK_MASK 0x02
+#define ACK_DELAY_TICKS 400
+#define ACK_HOLD_TICKS 3000
+
+struct cia
+{
+    uint8_t pra, prb, ddra, ddrb;
+    uint16_t ta, tb, ta_latch, tb_latch;
+    uint8_t cra, crb;
+    uint8_t icr_mask, icr_data;
+};
+
+struct machine
+{
+    // 8502
+    uint16_t pc;
+    uint8_t a, x, y, s, p;
+    int nmi_line;
+    int fast;
+
+    // Memory
+    uint8_t ram[2][0x10000];
+    uint8_t color_ram[0x400];
+    uint8_t kernal[HALF_ROM_SIZE];
+    uint8_t basic_lo[HALF_ROM_SIZE];
+    uint8_t basic_hi[HALF_ROM_SIZE];
+    uint8_t chargen[CHARGEN_SIZE];
+    uint8_t function_rom[ROM_SIZE];
+    uint8_t port_ddr, port_data;
+
+    // MMU
+    uint8_t cr, pcr[4], mcr, rcr, page[4];
+
+    // VIC-II
+    uint8_t vic[0x40];
+    uint16_t raster, raster_compare;
+    uint16_t line_tick;
+    uint8_t vic_latch;
+
+    // VDC
+    uint8_t vdc_select;
+    uint8_t vdc_reg[0x40];
+    uint8_t vdc_ram[0x10000];
+
+    uint8_t sid[0x20];
+    struct cia cia1, cia2;
+
+    // Keyboard: columns 0-7 on CIA1 port A, 8-10 on VIC $D02F
+    uint8_t matrix[11];
+
+    uint64_t cycles;
+    uint64_t half_ticks;
+    uint64_t ticks;
+};
+
+struct key_name
+{
+    const char *name;
+    uint8_t column, row;
+    uint8_t shifted;
+};
+
+struct interaction
+{
+    char label[64];
+    char keys[64];
+    uint64_t cycles;
+    double frames;
+    int timed_out;
+};
+
+static const char *program_name = "ultra36-harness";
+
+static struct machine m;
+static int col80;
+
+// Idle detection: the menu is waiting once it reads an empty key buffer
+// outside the IRQ handler after the pending key was consumed.
+static int watch_idle;
+static int key_seen;
+static int idle_hit;
+
+// Pressed key, released by tick count
+static uint8_t held_column[4], held_row[4];
+static int held_count;
+static uint64_t release_tick;
+
+// User Port bitstream and ATtiny acknowledge
+static int ack_enabled = 1;
+static uint8_t serial_bits;
+static uint8_t serial_value;
+static uint8_t serial_last_clock = 1;
+static uint8_t serial_bytes[MAX_SERIAL_BYTES];
+static int serial_count;
+static int serial_reported;
+static uint64_t ack_start;
+static uint64_t ack_end;
+static int ack_pending;
+
+// User Port trace (-v): line levels, drivers and port reads as VCD
+#define TRACE_SIGNALS 5
+
+static FILE *trace_file;
+static uint64_t trace_time = UINT64_MAX;
+static int trace_level[TRACE_SIGNALS] = {-1, -1, -1, -1, -1};
+static int trace_ack;
+static uint64_t trace_ack_rise;
+static uint64_t trace_ack_fall;
+
+static struct interaction interactions[MAX_INTERACTIONS];
+static int interaction_count;
+static int failures;
+
+static const struct key_name key_names[] = {
+    {"DEL", 0, 0, 0}, {"RETURN", 0, 1, 0}, {"RIGHT", 0, 2, 0},
+    {"F7", 0, 3, 0}, {"F1", 0, 4, 0}, {"F3", 0, 5, 0}, {"F5", 0, 6, 0},
+    {"DOWN", 0, 7, 0},
+    {"F8", 0, 3, 1}, {"F2", 0, 4, 1}, {"F4", 0, 5, 1}, {"F6", 0, 6, 1},
+    {"3", 1, 0, 0}, {"W", 1, 1, 0}, {"A", 1, 2, 0}, {"4", 1, 3, 0},
+    {"Z", 1, 4, 0}, {"S", 1, 5, 0}, {"E", 1, 6, 0}, {"SHIFT", 1, 7, 0},
+    {"5", 2, 0, 0}, {"R", 2, 1, 0}, {"D", 2, 2, 0}, {"6", 2, 3, 0},
+    {"C", 2, 4, 0}, {"F", 2, 5, 0}, {"T", 2, 6, 0}, {"X", 2, 7, 0},
+    {"7", 3, 0, 0}, {"Y", 3, 1, 0}, {"G", 3, 2, 0}, {"8", 3, 3, 0},
+    {"B", 3, 4, 0}, {"H", 3, 5, 0}, {"U", 3, 6, 0}, {"V", 3, 7, 0},
+    {"9", 4, 0, 0}, {"I", 4, 1, 0}, {"J", 4, 2, 0}, {"0", 4, 3, 0},
+    {"M", 4, 4, 0}, {"K", 4, 5, 0}, {"O", 4, 6, 0}, {"N", 4, 7, 0},
+    {"+", 5, 0, 0}, {"P", 5, 1, 0}, {"L", 5, 2, 0}, {"-", 5, 3, 0},
+    {".", 5, 4, 0}, {":", 5, 5, 0}, {"@", 5, 6, 0}, {",", 5, 7, 0},
+    {"*", 6, 1, 0}, {";", 6, 2, 0}, {"HOME", 6, 3, 0}, {"=", 6, 5, 0},
+    {"/", 6, 7, 0},
+    {"1", 7, 0, 0}, {"CTRL", 7, 2, 0}, {"2", 7, 3, 0}, {"SPACE", 7, 4, 0},
+    {"CBM", 7, 5, 0}, {"Q", 7, 6, 0}, {"STOP", 7, 7, 0},
+    {"HELP", 8, 0, 0}, {"TAB", 8, 3, 0},
+    {"ESC", 9, 0, 0}, {"ENTER", 9, 4, 0},
+    {"ALT", 10, 0, 0}, {"UP", 10, 3, 0}, {"LEFT", 10, 5, 0},
+};
+
+#define KEY_NAME_COUNT (sizeof(key_names) / sizeof(key_names[0]))
+
+static void fail(const char *format, ...)
+{
+    va_list ap;
+
+    fprintf(stderr, "%s: ", program_name);
+    va_start(ap, format);
+    vfprintf(stderr, format, ap);
+    va_end(ap);
+    fputc('\n', stderr);
+    exit(2);
+}
+
+static void usage(void)
+{
+    fprintf(stderr,
+            "usage: %s -k KERNAL [-c CHARGEN] [-b BASICLO -B BASICHI] [-8] "
+            "[-s SCRIPT] [-j REPORT.json] [-v TRACE.vcd] MENU.bin\n"
+            "  -k  16K C128 kernal image ($C000-$FFFF)\n"
+            "  -c  character ROM, seen at $D000 when I/O is banked out\n"
+            "  -b  BASIC low image, -B BASIC high image; with both the "
+            "machine boots\n"
+            "      from the reset vector instead of entering $8000 directly\n"
+            "  -8  hold 40/80 DISPLAY down (80-column VDC menu)\n"
+            "  -s  script file (default: standard input)\n"
+            "  -j  write the interaction timings as JSON\n"
+            "  -v  write a VCD trace of the User Port lines\n"
+            "Script commands, one per line ('#' starts a comment):\n"
+            "  idle [max FRAMES] [LABEL]      run until the menu waits for a key\n"
+            "  key K[*N][,K...] [max FRAMES] [LABEL]\n"
+            "                                 press keys, time until idle again\n"
+            "  wait FRAMES                    run for a number of frames\n"
+            "  expect TEXT                    fail unless TEXT is on screen\n"
+            "  dump [vic|vdc]                 print the screen\n"
+            "  serial                         print User Port bytes since last call\n"
+            "  ack on|off                     ATtiny acknowledges commands\n",
+            program_name);
+    exit(2);
+}
+
+static void load_file(const char *path, uint8_t *dest, size_t size,
+                      size_t min_size)
+{
+    FILE *file;
+    size_t got;
+
+    file = fopen(path, "rb");
+    if (file == NULL)
+        fail("cannot open %s", path);
+    got = fread(dest, 1, size, file);
+    fclose(file);
+    if (got < min_size)
+        fail("%s: expected %zu bytes, read %zu", path, min_size, got);
+}
+
+// ------------------------------------------------------------------------
+// Devices
+
+static void cia_reset(struct cia *cia)
+{
+    memset(cia, 0, sizeof(*cia));
+    cia->ta = cia->tb = cia->ta_latch = cia->tb_latch = 0xFFFF;
+}
+
+static int cia_irq(const struct cia *cia)
+{
+    return (cia->icr_data & cia->icr_mask & 0x1F) != 0;
+}
+
+static void cia_tick(struct cia *cia)
+{
+    int underflow_a = 0;
+
+    if (cia->cra & 0x01)
+    {
+        if (cia->ta == 0)
+        {
+            underflow_a = 1;
+            cia->icr_data |= 0x01;
+            cia->ta = cia->ta_latch;
+            if (cia->cra & 0x08)
+                cia->cra &= (uint8_t)~0x01;
+        }
+        else
+            cia->ta--;
+    }
+
+    if (cia->crb & 0x01)
+    {
+        int count = (cia->crb & 0x60) == 0x00 ||
+                    ((cia->crb & 0x60) == 0x40 && underflow_a);
+
+        if (count)
+        {
+            if (cia->tb == 0)
+            {
+                cia->icr_data |= 0x02;
+                cia->tb = cia->tb_latch;
+                if (cia->crb & 0x08)
+                    cia->crb &= (uint8_t)~0x01;
+            }
+            else
+                cia->tb--;
+        }
+    }
+}
+
+static uint8_t cia_read(struct cia *cia, uint8_t reg)
+{
+    uint8_t value;
+
+    switch (reg & 0x0F)
+    {
+    case 0x00:
+        return (uint8_t)((cia->pra & cia->ddra) | (uint8_t)~cia->ddra);
+    case 0x01:
+        return (uint8_t)((cia->prb & cia->ddrb) | (uint8_t)~cia->ddrb);
+    case 0x02:
+        return cia->ddra;
+    case 0x03:
+        return cia->ddrb;
+    case 0x04:
+        return (uint8_t)cia->ta;
+    case 0x05:
+        return (uint8_t)(cia->ta >> 8);
+    case 0x06:
+        return (uint8_t)cia->tb;
+    case 0x07:
+        return (uint8_t)(cia->tb >> 8);
+    case 0x0D:
+        value = cia->icr_data;
+        if (cia_irq(cia))
+            value |= 0x80;
+        cia->icr_data = 0;
+        return value;
+    case 0x0E:
+        return cia->cra;
+    case 0x0F:
+        return cia->crb;
+    default:
+        return 0x00;             // TOD and serial shift register unused
+    }
+}
+
+static void cia_write(struct cia *cia, uint8_t reg, uint8_t value)
+{
+    switch (reg & 0x0F)
+    {
+    case 0x00:
+        cia->pra = value;
+        break;
+    case 0x01:
+        cia->prb = value;
+        break;
+    case 0x02:
+        cia->ddra = value;
+        break;
+    case 0x03:
+        cia->ddrb = value;
+        break;
+    case 0x04:
+        cia->ta_latch = (uint16_t)((cia->ta_latch & 0xFF00) | value);
+        break;
+    case 0x05:
+        cia->ta_latch = (uint16_t)((cia->ta_latch & 0x00FF) | (value << 8));
+        if (!(cia->cra & 0x01))
+            cia->ta = cia->ta_latch;
+        break;
+    case 0x06:
+        cia->tb_latch = (uint16_t)((cia->tb_latch & 0xFF00) | value);
+        break;
+    case 0x07:
+        cia->tb_latch = (uint16_t)((cia->tb_latch & 0x00FF) | (value << 8));
+        if (!(cia->crb & 0x01))
+            cia->tb = cia->tb_latch;
+        break;
+    case 0x0D:
+        if (value & 0x80)
+            cia->icr_mask |= value & 0x1F;
+        else
+            cia->icr_mask &= (uint8_t)~(value & 0x1F);
+        break;
+    case 0x0E:
+        if (value & 0x10)
+            cia->ta = cia->ta_latch;
+        cia->cra = value & (uint8_t)~0x10;
+        break;
+    case 0x0F:
+        if (value & 0x10)
+            cia->tb = cia->tb_latch;
+        cia->crb = value & (uint8_t)~0x10;
+        break;
+    default:
+        break;
+    }
+}
+
+static uint8_t keyboard_rows(void)
+{
+    uint8_t columns = cia_read(&m.cia1, 0x00);
+    uint8_t rows = 0xFF;
+    int column;
+
+    for (column = 0; column < 8; column++)
+        if (!(columns & (1 << column)))
+            rows &= (uint8_t)~m.matrix[column];
+    for (column = 0; column < 3; column++)
+        if (!(m.vic[0x2F] & (1 << column)))
+            rows &= (uint8_t)~m.matrix[8 + column];
+    return rows;
+}
+
+// The ATtiny samples data on each rising clock edge while both lines are
+// driven, then acknowledges by pulling data low once the C128 releases it.
+static void serial_update(void)
+{
+    uint8_t ddr = m.cia2.ddrb;
+    uint8_t out = m.cia2.prb;
+    uint8_t clock = (ddr & SERIAL_CLOCK_MASK) ? (out & SERIAL_CLOCK_MASK) != 0 : 1;
+
+    if ((ddr & (SERIAL_DATA_MASK | SERIAL_CLOCK_MASK)) ==
+        (SERIAL_DATA_MASK | SERIAL_CLOCK_MASK))
+    {
+        if (clock && !serial_last_clock)
+        {
+            serial_value = (uint8_t)((serial_value << 1) |
+                                     ((out & SERIAL_DATA_MASK) ? 1 : 0));
+            if (++serial_bits == 8)
+            {
+                if (serial_count < MAX_SERIAL_BYTES)
+                    serial_bytes[serial_count++] = serial_value;
+                serial_bits = 0;
+                ack_pending = ack_enabled;
+            }
+        }
+    }
+    else if (!(ddr & SERIAL_DATA_MASK) && ack_pending)
+    {
+        ack_pending = 0;
+        ack_start = m.ticks + ACK_DELAY_TICKS;
+        ack_end = ack_start + ACK_HOLD_TICKS;
+        trace_ack_rise = ack_start;
+        trace_ack_fall = ack_end;
+    }
+
+    if (!(ddr & SERIAL_CLOCK_MASK))
+        serial_bits = 0;
+    serial_last_clock = clock;
+}
+
+// ------------------------------------------------------------------------
+// User Port trace. Times are in ns from power-on at the nominal 1 MHz tick;
+// an access is stamped with the cycle its instruction started in.
+
+static void trace_open(const char *path)
+{
+    static const char *const names[TRACE_SIGNALS] = {
+        "data", "clock", "data_out", "clock_out", "tiny_ack"
+    };
+    int i;
+
+    trace_file = fopen(path, "w");
+    if (trace_file == NULL)
+        fail("cannot create %s", path);
+    fprintf(trace_file, "$version ultra36-harness $end\n"
+                        "$timescale 1 ns $end\n"
+                        "$scope module user_port $end\n");
+    for (i = 0; i < TRACE_SIGNALS; i++)
+        fprintf(trace_file, "$var wire 1 %c %s $end\n", '!' + i, names[i]);
+    fprintf(trace_file, "$var event 1 & read $end\n"
+                        "$var event 1 ' write $end\n"
+                        "$var wire 8 ( prb_read $end\n"
+                        "$upscope $end\n"
+                        "$enddefinitions $end\n");
+}
+
+static uint64_t trace_now(void)
+{
+    return m.ticks * 1000 + m.half_ticks * 500;
+}
+
+static void trace_stamp(uint64_t time)
+{
+    if (time != trace_time)
+    {
+        fprintf(trace_file, "#%llu\n", (unsigned long long)time);
+        trace_time = time;
+    }
+}
+
+// Data and clock are open collector: released lines read high unless the
+// ATtiny pulls data low to acknowledge.
+static void trace_levels(uint64_t time)
+{
+    uint8_t ddr = m.cia2.ddrb;
+    uint8_t out = m.cia2.prb;
+    int level[TRACE_SIGNALS];
+    int i;
+
+    level[2] = (ddr & SERIAL_DATA_MASK) != 0;
+    level[3] = (ddr & SERIAL_CLOCK_MASK) != 0;
+    level[0] = level[2] ? (out & SERIAL_DATA_MASK) != 0 : !trace_ack;
+    level[1] = level[3] ? (out & SERIAL_CLOCK_MASK) != 0 : 1;
+    level[4] = trace_ack;
+    for (i = 0; i < TRACE_SIGNALS; i++)
+    {
+        if (level[i] != trace_level[i])
+        {
+            trace_stamp(time);
+            fprintf(trace_file, "%d%c\n", level[i], '!' + i);
+            trace_level[i] = level[i];
+        }
+    }
+}
+
+// Write out the acknowledge edges that fell between two port accesses
+static void trace_catch_up(void)
+{
+    if (trace_file == NULL)
+        return;
+    if (trace_ack_rise != 0 && trace_ack_rise <= m.ticks)
+    {
+        trace_ack = 1;
+        trace_levels(trace_ack_rise * 1000);
+        trace_ack_rise = 0;
+    }
+    if (trace_ack_rise == 0 && trace_ack_fall != 0 &&
+        trace_ack_fall <= m.ticks)
+    {
+        trace_ack = 0;
+        trace_levels(trace_ack_fall * 1000);
+        trace_ack_fall = 0;
+    }
+}
+
+static void trace_write(void)
+{
+    if (trace_file == NULL)
+        return;
+    trace_stamp(trace_now());
+    fprintf(trace_file, "1'\n");
+    trace_levels(trace_now());
+}
+
+static void trace_read(uint8_t value)
+{
+    int bit;
+
+    if (trace_file == NULL)
+        return;
+    trace_catch_up();
+    trace_stamp(trace_now());
+    fprintf(trace_file, "1&\nb");
+    for (bit = 7; bit >= 0; bit--)
+        fputc((value >> bit) & 1 ? '1' : '0', trace_file);
+    fprintf(trace_file, " (\n");
+}
+
+static void trace_close(void)
+{
+    if (trace_file == NULL)
+        return;
+    trace_catch_up();
+    trace_stamp(trace_now());
+    if (fclose(trace_file) != 0)
+        fail("%s", "cannot write the User Port trace");
+}
+
+static uint8_t user_port_read(void)
+{
+    uint8_t value = cia_read(&m.cia2, 0x01);
+
+    if (!(m.cia2.ddrb & SERIAL_DATA_MASK) &&
+        m.ticks >= ack_start && m.ticks < ack_end)
+        value &= (uint8_t)~SERIAL_DATA_MASK;
+    trace_read(value);
+    return value;
+}
+
+static uint16_t vdc_address(uint8_t high_reg)
+{
+    return (uint16_t)((m.vdc_reg[high_reg] << 8) | m.vdc_reg[high_reg + 1]);
+}
+
+static void vdc_set_address(uint8_t high_reg, uint16_t address)
+{
+    m.vdc_reg[high_reg] = (uint8_t)(address >> 8);
+    m.vdc_reg[high_reg + 1] = (uint8_t)address;
+}
+
+static uint16_t vdc_mask(void)
+{
+    return (m.vdc_reg[28] & 0x10) ? 0xFFFF : 0x3FFF;
+}
+
+static void vdc_write(uint8_t value)
+{
+    uint8_t reg = m.vdc_select;
+    uint16_t update = vdc_address(18);
+    uint16_t source;
+    unsigned int count;
+
+    switch (reg)
+    {
+    case 31:
+        m.vdc_reg[31] = value;
+        m.vdc_ram[update & vdc_mask()] = value;
+        vdc_set_address(18, (uint16_t)(update + 1));
+        break;
+    case 30:
+        m.vdc_reg[30] = value;
+        count = value ? value : 256;
+        source = vdc_address(32);
+        while (count--)
+        {
+            if (m.vdc_reg[24] & 0x80)
+                m.vdc_ram[update & vdc_mask()] =
+                    m.vdc_ram[source++ & vdc_mask()];
+            else
+                m.vdc_ram[update & vdc_mask()] = m.vdc_reg[31];
+            update++;
+        }
+        vdc_set_address(18, update);
+        if (m.vdc_reg[24] & 0x80)
+            vdc_set_address(32, source);
+        break;
+    default:
+        m.vdc_reg[reg & 0x3F] = value;
+        break;
+    }
+}
+
+static uint8_t vdc_read(void)
+{
+    uint16_t update;
+    uint8_t value;
+
+    if (m.vdc_select == 31)
+    {
+        update = vdc_address(18);
+        value = m.vdc_ram[update & vdc_mask()];
+        vdc_set_address(18, (uint16_t)(update + 1));
+        return value;
+    }
+    if (m.vdc_select > 36)
+        return 0xFF;
+    return m.vdc_reg[m.vdc_select];
+}
+
+static int in_vblank(void)
+{
+    return m.raster >= VBLANK_FIRST_LINE || m.raster <= VBLANK_LAST_LINE;
+}
+
+static uint8_t vic_read(uint8_t reg)
+{
+    reg &= 0x3F;
+    switch (reg)
+    {
+    case 0x11:
+        return (uint8_t)((m.vic[0x11] & 0x7F) | ((m.raster & 0x100) >> 1));
+    case 0x12:
+        return (uint8_t)m.raster;
+    case 0x19:
+        return (uint8_t)(m.vic_latch | 0x70 |
+                         ((m.vic_latch & m.vic[0x1A] & 0x0F) ? 0x80 : 0));
+    case 0x1E:
+    case 0x1F:
+        return 0x00;
+    case 0x2F:
+        return m.vic[0x2F] | 0xF8;
+    case 0x30:
+        return m.vic[0x30] | 0xFC;
+    default:
+        return reg < 0x31 ? m.vic[reg] : 0xFF;
+    }
+}
+
+static void vic_write(uint8_t reg, uint8_t value)
+{
+    reg &= 0x3F;
+    switch (reg)
+    {
+    case 0x11:
+        m.vic[0x11] = value;
+        m.raster_compare = (uint16_t)((m.raster_compare & 0xFF) |
+                                      ((value & 0x80) << 1));
+        break;
+    case 0x12:
+        m.raster_compare = (uint16_t)((m.raster_compare & 0x100) | value);
+        break;
+    case 0x19:
+        m.vic_latch &= (uint8_t)~value;
+        break;
+    case 0x30:
+        m.vic[0x30] = value;
+        m.fast = value & 0x01;
+        break;
+    default:
+        m.vic[reg] = value;
+        break;
+    }
+}
+
+static uint8_t mcr_read(void)
+{
+    // Bit 7 is the 40/80 DISPLAY key (0 = down); no C64 cartridge present
+    return (uint8_t)((m.mcr & 0x49) | 0x36 | (col80 ? 0x00 : 0x80));
+}
+
+static uint8_t io_read(uint16_t addr)
+{
+    if (addr < 0xD400)
+        return vic_read((uint8_t)addr);
+    if (addr < 0xD500)
+    {
+        if ((addr & 0x1F) == 0x1B || (addr & 0x1F) == 0x1C)
+            return (uint8_t)rand();
+        return 0x00;
+    }
+    if (addr < 0xD600)
+    {
+        switch (addr & 0xFF)
+        {
+        case 0x00:
+            return m.cr;
+        case 0x01: case 0x02: case 0x03: case 0x04:
+            return m.pcr[(addr & 0xFF) - 1];
+        case 0x05:
+            return mcr_read();
+        case 0x06:
+            return m.rcr;
+        case 0x07: case 0x08: case 0x09: case 0x0A:
+            return m.page[(addr & 0xFF) - 7];
+        case 0x0B:
+            return 0x20;        // 128K, MMU version 0
+        default:
+            return 0xFF;
+        }
+    }
+    if (addr < 0xD700)
+    {
+        if (addr & 1)
+            return vdc_read();
+        return (uint8_t)(0x80 | (in_vblank() ? 0x20 : 0x00) | 0x01);
+    }
+    if (addr < 0xD800)
+        return 0xFF;
+    if (addr < 0xDC00)
+        return (uint8_t)(m.color_ram[addr & 0x3FF] | 0xF0);
+    if (addr < 0xDD00)
+    {
+        if ((addr & 0x0F) == 0x01)
+            return (uint8_t)(keyboard_rows() & cia_read(&m.cia1, 0x01));
+        return cia_read(&m.cia1, (uint8_t)addr);
+    }
+    if (addr < 0xDE00)
+    {
+        if ((addr & 0x0F) == 0x00)
+        {
+            // Serial bus inputs read back the inverted ATN/CLK/DATA outputs
+            uint8_t value = cia_read(&m.cia2, 0x00) & 0x3F;
+
+            if (!(m.cia2.pra & 0x10))
+                value |= 0x40;
+            if (!(m.cia2.pra & 0x20))
+                value |= 0x80;
+            return value;
+        }
+        if ((addr & 0x0F) == 0x01)
+            return user_port_read();
+        return cia_read(&m.cia2, (uint8_t)addr);
+    }
+    return 0xFF;
+}
+
+static void io_write(uint16_t addr, uint8_t value)
+{
+    if (addr < 0xD400)
+        vic_write((uint8_t)addr, value);
+    else if (addr < 0xD500)
+        m.sid[addr & 0x1F] = value;
+    else if (addr < 0xD600)
+    {
+        switch (addr & 0xFF)
+        {
+        case 0x00:
+            m.cr = value;
+            break;
+        case 0x01: case 0x02: case 0x03: case 0x04:
+            m.pcr[(addr & 0xFF) - 1] = value;
+            break;
+        case 0x05:
+            m.mcr = value;
+            if (value & 0x40)
+                fail("menu switched to C64 mode at $%04X", m.pc);
+            break;
+        case 0x06:
+            m.rcr = value;
+            break;
+        case 0x07: case 0x08: case 0x09: case 0x0A:
+            m.page[(addr & 0xFF) - 7] = value;
+            break;
+        default:
+            break;
+        }
+    }
+    else if (addr < 0xD700)
+    {
+        if (addr & 1)
+            vdc_write(value);
+        else
+            m.vdc_select = value & 0x3F;
+    }
+    else if (addr >= 0xD800 && addr < 0xDC00)
+        m.color_ram[addr & 0x3FF] = value & 0x0F;
+    else if (addr >= 0xDC00 && addr < 0xDD00)
+        cia_write(&m.cia1, (uint8_t)addr, value);
+    else if (addr >= 0xDD00 && addr < 0xDE00)
+    {
+        if ((addr & 0x0F) == 0x01 || (addr & 0x0F) == 0x03)
+            trace_catch_up();
+        cia_write(&m.cia2, (uint8_t)addr, value);
+        if ((addr & 0x0F) == 0x01 || (addr & 0x0F) == 0x03)
+        {
+            serial_update();
+            trace_write();
+        }
+    }
+}
+
+// ------------------------------------------------------------------------
+// MMU
+
+static int ram_bank(uint16_t addr)
+{
+    static const uint16_t common_size[4] = {0x0400, 0x1000, 0x2000, 0x4000};
+    uint16_t size;
+
+    // Zero page and stack stay in bank 0 (P0/P1 relocation is not modelled)
+    if (addr < 0x0200 || !(m.cr & 0x40))
+        return 0;
+    size = common_size[m.rcr & 0x03];
+    if ((m.rcr & 0x04) && addr < size)
+        return 0;
+    if ((m.rcr & 0x08) && addr >= (uint16_t)(0x10000 - size))
+        return 0;
+    return 1;
+}
+
+static uint8_t read8(uint16_t addr)
+{
+    uint8_t value;
+
+    if (addr >= 0xFF00 && addr <= 0xFF04)
+        return addr == 0xFF00 ? m.cr : m.pcr[addr - 0xFF01];
+    if (addr < 0x0002)
+    {
+        if (addr == 0)
+            return m.port_ddr;
+        return (uint8_t)((m.port_data & m.port_ddr) | (uint8_t)~m.port_ddr);
+    }
+
+    if (addr >= 0x4000 && addr < 0x8000 && !(m.cr & 0x02))
+        return m.basic_lo[addr - 0x4000];
+    if (addr >= 0x8000 && addr < 0xC000)
+    {
+        switch ((m.cr >> 2) & 0x03)
+        {
+        case 0:
+            return m.basic_hi[addr - 0x8000];
+        case 1:
+            return m.function_rom[addr - 0x8000];
+        case 2:
+            return 0xFF;        // No external function ROM
+        default:
+            break;
+        }
+    }
+    if (addr >= 0xC000)
+    {
+        if (addr >= 0xD000 && addr < 0xE000 && !(m.cr & 0x01))
+            return io_read(addr);
+        switch ((m.cr >> 4) & 0x03)
+        {
+        case 0:
+            if (addr >= 0xD000 && addr < 0xE000)
+                return m.chargen[addr - 0xD000];
+            return m.kernal[addr - 0xC000];
+        case 1:
+            return m.function_rom[HALF_ROM_SIZE + addr - 0xC000];
+        case 2:
+            return 0xFF;
+        default:
+            break;
+        }
+    }
+
+    value = m.ram[ram_bank(addr)][addr];
+    if (addr == KEY_COUNT && watch_idle && key_seen && value == 0 &&
+        !(m.p & FLAG_I))
+        idle_hit = 1;
+    return value;
+}
+
+static void write8(uint16_t addr, uint8_t value)
+{
+    if (addr >= 0xFF00 && addr <= 0xFF04)
+    {
+        if (addr == 0xFF00)
+            m.cr = value;
+        else
+            m.cr = m.pcr[addr - 0xFF01];
+        return;
+    }
+    if (addr < 0x0002)
+    {
+        if (addr == 0)
+            m.port_ddr = value;
+        else
+            m.port_data = value;
+        return;
+    }
+    if (addr >= 0xD000 && addr < 0xE000 && !(m.cr & 0x01))
+    {
+        io_write(addr, value);
+        return;
+    }
+    if (addr == KEY_COUNT && value != 0)
+        key_seen = 1;
+    m.ram[ram_bank(addr)][addr] = value;
+}
+
+// ------------------------------------------------------------------------
+// Clocks: VIC raster, CIA timers, key release, interrupts
+
+static void tick(void)
+{
+    int cia2_irq = cia_irq(&m.cia2);
+
+    m.ticks++;
+    if (++m.line_tick == TICKS_PER_LINE)
+    {
+        m.line_tick = 0;
+        if (++m.raster == LINES_PER_FRAME)
+            m.raster = 0;
+        if (m.raster == m.raster_compare)
+            m.vic_latch |= 0x01;
+    }
+    cia_tick(&m.cia1);
+    cia_tick(&m.cia2);
+    if (!cia2_irq && cia_irq(&m.cia2))
+        m.nmi_line = 1;
+
+    if (held_count && m.ticks >= release_tick)
+    {
+        while (held_count)
+        {
+            held_count--;
+            m.matrix[held_column[held_count]] &=
+                (uint8_t)~(1 << held_row[held_count]);
+        }
+    }
+}
+
+static void advance(unsigned int cycles)
+{
+    m.cycles += cycles;
+    m.half_ticks += m.fast ? cycles : 2u * cycles;
+    while (m.half_ticks >= 2)
+    {
+        m.half_ticks -= 2;
+        tick();
+    }
+}
+
+static int irq_line(void)
+{
+    return (m.vic_latch & m.vic[0x1A] & 0x0F) || cia_irq(&m.cia1);
+}
+
+// ------------------------------------------------------------------------
+// 6502 core (documented opcodes, NMOS timing)
+
+static const uint8_t cycle_table[256] = {
+    7, 6, 0, 0, 0, 3, 5, 0, 3, 2, 2, 0, 0, 4, 6, 0,
+    2, 5, 0, 0, 0, 4, 6, 0, 2, 4, 0, 0, 0, 4, 7, 0,
+    6, 6, 0, 0, 3, 3, 5, 0, 4, 2, 2, 0, 4, 4, 6, 0,
+    2, 5, 0, 0, 0, 4, 6, 0, 2, 4, 0, 0, 0, 4, 7, 0,
+    6, 6, 0, 0, 0, 3, 5, 0, 3, 2, 2, 0, 3, 4, 6, 0,
+    2, 5, 0, 0, 0, 4, 6, 0, 2, 4, 0, 0, 0, 4, 7, 0,
+    6, 6, 0, 0, 0, 3, 5, 0, 4, 2, 2, 0, 5, 4, 6, 0,
+    2, 5, 0, 0, 0, 4, 6, 0, 2, 4, 0, 0, 0, 4, 7, 0,
+    0, 6, 0, 0, 3, 3, 3, 0, 2, 0, 2, 0, 4, 4, 4, 0,
+    2, 6, 0, 0, 4, 4, 4, 0, 2, 5, 2, 0, 0, 5, 0, 0,
+    2, 6, 2, 0, 3, 3, 3, 0, 2, 2, 2, 0, 4, 4, 4, 0,
+    2, 5, 0, 0, 4, 4, 4, 0, 2, 4, 2, 0, 4, 4, 4, 0,
+    2, 6, 0, 0, 3, 3, 5, 0, 2, 2, 2, 0, 4, 4, 6, 0,
+    2, 5, 0, 0, 0, 4, 6, 0, 2, 4, 0, 0, 0, 4, 7, 0,
+    2, 6, 0, 0, 3, 3, 5, 0, 2, 2, 2, 0, 4, 4, 6, 0,
+    2, 5, 0, 0, 0, 4, 6, 0, 2, 4, 0, 0, 0, 4, 7, 0,
+};
+
+static unsigned int extra_cycles;
+
+static uint16_t read16(uint16_t addr)
+{
+    return (uint16_t)(read8(addr) | (read8((uint16_t)(addr + 1)) << 8));
+}
+
+// JMP ($xxFF) wraps within the page on NMOS parts
+static uint16_t read16_wrapped(uint16_t addr)
+{
+    uint16_t high = (uint16_t)((addr & 0xFF00) | ((addr + 1) & 0x00FF));
+
+    return (uint16_t)(read8(addr) | (read8(high) << 8));
+}
+
+static uint8_t fetch(void)
+{
+    return read8(m.pc++);
+}
+
+static uint16_t fetch16(void)
+{
+    uint16_t value = read16(m.pc);
+
+    m.pc = (uint16_t)(m.pc + 2);
+    return value;
+}
+
+static void push(uint8_t value)
+{
+    m.ram[0][0x0100 | m.s] = value;
+    m.s--;
+}
+
+static uint8_t pull(void)
+{
+    m.s++;
+    return m.ram[0][0x0100 | m.s];
+}
+
+static void set_nz(uint8_t value)
+{
+    m.p = (uint8_t)((m.p & ~(FLAG_N | FLAG_Z)) | (value & FLAG_N) |
+                    (value ? 0 : FLAG_Z));
+}
+
+static uint16_t indexed(uint16_t base, uint8_t index, int page_penalty)
+{
+    uint16_t addr = (uint16_t)(base + index);
+
+    if (page_penalty && (addr & 0xFF00) != (base & 0xFF00))
+        extra_cycles++;
+    return addr;
+}
+
+// Effective address for the operand of opcode, penalty for read-only ops
+static uint16_t operand_address(uint8_t opcode, int page_penalty)
+{
+    uint8_t zp;
+
+    switch (opcode & 0x1F)
+    {
+    case 0x01: case 0x03:                               // (zp,X)
+        zp = (uint8_t)(fetch() + m.x);
+        return (uint16_t)(m.ram[0][zp] | (m.ram[0][(uint8_t)(zp + 1)] << 8));
+    case 0x11: case 0x13:                               // (zp),Y
+        zp = fetch();
+        return indexed((uint16_t)(m.ram[0][zp] |
+                                  (m.ram[0][(uint8_t)(zp + 1)] << 8)),
+                       m.y, page_penalty);
+    case 0x04: case 0x05: case 0x06: case 0x07:         // zp
+        return fetch();
+    case 0x14: case 0x15: case 0x16: case 0x17:         // zp,X / zp,Y
+        if (opcode == 0x96 || opcode == 0xB6)
+            return (uint8_t)(fetch() + m.y);
+        return (uint8_t)(fetch() + m.x);
+    case 0x0C: case 0x0D: case 0x0E: case 0x0F:         // abs
+        return fetch16();
+    case 0x19: case 0x1B:                               // abs,Y
+        return indexed(fetch16(), m.y, page_penalty);
+    case 0x1C: case 0x1D: case 0x1E: case 0x1F:         // abs,X / abs,Y
+        if (opcode == 0xBE)
+            return indexed(fetch16(), m.y, page_penalty);
+        return indexed(fetch16(), m.x, page_penalty);
+    default:
+        return m.pc++;                                  // #immediate
+    }
+}
+
+static void branch(int condition)
+{
+    int8_t offset = (int8_t)fetch();
+    uint16_t target;
+
+    if (!condition)
+        return;
+    target = (uint16_t)(m.pc + offset);
+    extra_cycles += ((target & 0xFF00) != (m.pc & 0xFF00)) ? 2 : 1;
+    m.pc = target;
+}
+
+static void adc(uint8_t value)
+{
+    unsigned int carry = m.p & FLAG_C;
+    unsigned int sum = m.a + value + carry;
+
+    if (m.p & FLAG_D)
+    {
+        unsigned int low = (m.a & 0x0F) + (value & 0x0F) + carry;
+        unsigned int high;
+
+        if (low > 9)
+            low += 6;
+        high = (m.a >> 4) + (value >> 4) + (low > 0x0F);
+        m.p &= (uint8_t)~(FLAG_Z | FLAG_N | FLAG_V | FLAG_C);
+        if (!(sum & 0xFF))
+            m.p |= FLAG_Z;
+        if (high & 0x08)
+            m.p |= FLAG_N;
+        if (~(m.a ^ value) & (m.a ^ (high << 4)) & 0x80)
+            m.p |= FLAG_V;
+        if (high > 9)
+            high += 6;
+        if (high > 0x0F)
+            m.p |= FLAG_C;
+        m.a = (uint8_t)((high << 4) | (low & 0x0F));
+        return;
+    }
+
+    m.p &= (uint8_t)~(FLAG_V | FLAG_C);
+    if (~(m.a ^ value) & (m.a ^ sum) & 0x80)
+        m.p |= FLAG_V;
+    if (sum > 0xFF)
+        m.p |= FLAG_C;
+    m.a = (uint8_t)sum;
+    set_nz(m.a);
+}
+
+static void sbc(uint8_t value)
+{
+    unsigned int borrow = (m.p & FLAG_C) ? 0 : 1;
+    unsigned int diff = (unsigned int)m.a - value - borrow;
+
+    if (m.p & FLAG_D)
+    {
+        int low = (m.a & 0x0F) - (value & 0x0F) - (int)borrow;
+        int high = (m.a >> 4) - (value >> 4);
+
+        if (low < 0)
+        {
+            low -= 6;
+            high--;
+        }
+        if (high < 0)
+            high -= 6;
+        m.p &= (uint8_t)~(FLAG_V | FLAG_C);
+        if ((m.a ^ value) & (m.a ^ diff) & 0x80)
+            m.p |= FLAG_V;
+        if (diff < 0x100)
+            m.p |= FLAG_C;
+        set_nz((uint8_t)diff);
+        m.a = (uint8_t)((high << 4) | (low & 0x0F));
+        return;
+    }
+
+    m.p &= (uint8_t)~(FLAG_V | FLAG_C);
+    if ((m.a ^ value) & (m.a ^ diff) & 0x80)
+        m.p |= FLAG_V;
+    if (diff < 0x100)
+        m.p |= FLAG_C;
+    m.a = (uint8_t)diff;
+    set_nz(m.a);
+}
+
+static void compare(uint8_t reg, uint8_t value)
+{
+    unsigned int diff = (unsigned int)reg - value;
+
+    m.p = (uint8_t)((m.p & ~FLAG_C) | (reg >= value ? FLAG_C : 0));
+    set_nz((uint8_t)diff);
+}
+
+static uint8_t shift(uint8_t opcode, uint8_t value)
+{
+    uint8_t carry_in = m.p & FLAG_C;
+    uint8_t result;
+
+    switch (opcode >> 5)
+    {
+    case 0:                                     // ASL
+        m.p = (uint8_t)((m.p & ~FLAG_C) | (value >> 7));
+        result = (uint8_t)(value << 1);
+        break;
+    case 1:                                     // ROL
+        m.p = (uint8_t)((m.p & ~FLAG_C) | (value >> 7));
+        result = (uint8_t)((value << 1) | carry_in);
+        break;
+    case 2:                                     // LSR
+        m.p = (uint8_t)((m.p & ~FLAG_C) | (value & 0x01));
+        result = (uint8_t)(value >> 1);
+        break;
+    case 3:                                     // ROR
+        m.p = (uint8_t)((m.p & ~FLAG_C) | (value & 0x01));
+        result = (uint8_t)((value >> 1) | (carry_in << 7));
+        break;
+    case 6:                                     // DEC
+        result = (uint8_t)(value - 1);
+        break;
+    default:                                    // INC
+        result = (uint8_t)(value + 1);
+        break;
+    }
+    set_nz(result);
+    return result;
+}
+
+static void interrupt(uint16_t vector, int brk)
+{
+    push((uint8_t)(m.pc >> 8));
+    push((uint8_t)m.pc);
+    push((uint8_t)(m.p | FLAG_U | (brk ? FLAG_B : 0)));
+    m.p |= FLAG_I;
+    m.pc = read16(vector);
+}
+
+static void step(void)
+{
+    uint8_t opcode;
+    uint16_t addr;
+    uint8_t value;
+
+    if (m.nmi_line)
+    {
+        m.nmi_line = 0;
+        interrupt(0xFFFA, 0);
+        advance(7);
+        return;
+    }
+    if (!(m.p & FLAG_I) && irq_line())
+    {
+        interrupt(0xFFFE, 0);
+        advance(7);
+        return;
+    }
+
+    opcode = fetch();
+    extra_cycles = 0;
+    if (cycle_table[opcode] == 0)
+        fail("illegal opcode $%02X at $%04X", opcode, (uint16_t)(m.pc - 1));
+
+    switch (opcode)
+    {
+    // Loads, stores and ALU ops share the addressing decode
+    case 0xA1: case 0xA5: case 0xA9: case 0xAD: case 0xB1: case 0xB5:
+    case 0xB9: case 0xBD:
+        m.a = read8(operand_address(opcode, 1));
+        set_nz(m.a);
+        break;
+    case 0xA2: case 0xA6: case 0xAE: case 0xB6: case 0xBE:
+        m.x = read8(operand_address(opcode == 0xA2 ? 0x09 : opcode, 1));
+        set_nz(m.x);
+        break;
+    case 0xA0: case 0xA4: case 0xAC: case 0xB4: case 0xBC:
+        m.y = read8(operand_address(opcode == 0xA0 ? 0x09 : opcode, 1));
+        set_nz(m.y);
+        break;
+    case 0x81: case 0x85: case 0x8D: case 0x91: case 0x95: case 0x99:
+    case 0x9D:
+        write8(operand_address(opcode, 0), m.a);
+        break;
+    case 0x86: case 0x8E: case 0x96:
+        write8(operand_address(opcode, 0), m.x);
+        break;
+    case 0x84: case 0x8C: case 0x94:
+        write8(operand_address(opcode, 0), m.y);
+        break;
+    case 0x01: case 0x05: case 0x09: case 0x0D: case 0x11: case 0x15:
+    case 0x19: case 0x1D:
+        m.a |= read8(operand_address(opcode, 1));
+        set_nz(m.a);
+        break;
+    case 0x21: case 0x25: case 0x29: case 0x2D: case 0x31: case 0x35:
+    case 0x39: case 0x3D:
+        m.a &= read8(operand_address(opcode, 1));
+        set_nz(m.a);
+        break;
+    case 0x41: case 0x45: case 0x49: case 0x4D: case 0x51: case 0x55:
+    case 0x59: case 0x5D:
+        m.a ^= read8(operand_address(opcode, 1));
+        set_nz(m.a);
+        break;
+    case 0x61: case 0x65: case 0x69: case 0x6D: case 0x71: case 0x75:
+    case 0x79: case 0x7D:
+        adc(read8(operand_address(opcode, 1)));
+        break;
+    case 0xE1: case 0xE5: case 0xE9: case 0xED: case 0xF1: case 0xF5:
+    case 0xF9: case 0xFD:
+        sbc(read8(operand_address(opcode, 1)));
+        break;
+    case 0xC1: case 0xC5: case 0xC9: case 0xCD: case 0xD1: case 0xD5:
+    case 0xD9: case 0xDD:
+        compare(m.a, read8(operand_address(opcode, 1)));
+        break;
+    case 0xE0: case 0xE4: case 0xEC:
+        compare(m.x, read8(operand_address(opcode == 0xE0 ? 0x09 : opcode, 1)));
+        break;
+    case 0xC0: case 0xC4: case 0xCC:
+        compare(m.y, read8(operand_address(opcode == 0xC0 ? 0x09 : opcode, 1)));
+        break;
+    case 0x24: case 0x2C:
+        value = read8(operand_address(opcode, 1));
+        m.p = (uint8_t)((m.p & ~(FLAG_N | FLAG_V | FLAG_Z)) |
+                        (value & (FLAG_N | FLAG_V)) |
+                        ((value & m.a) ? 0 : FLAG_Z));
+        break;
+
+    // Read-modify-write
+    case 0x0A: case 0x2A: case 0x4A: case 0x6A:
+        m.a = shift(opcode, m.a);
+        break;
+    case 0x06: case 0x0E: case 0x16: case 0x1E:
+    case 0x26: case 0x2E: case 0x36: case 0x3E:
+    case 0x46: case 0x4E: case 0x56: case 0x5E:
+    case 0x66: case 0x6E: case 0x76: case 0x7E:
+    case 0xC6: case 0xCE: case 0xD6: case 0xDE:
+    case 0xE6: case 0xEE: case 0xF6: case 0xFE:
+        addr = operand_address(opcode, 0);
+        write8(addr, shift(opcode, read8(addr)));
+        break;
+
+    // Register transfers and increments
+    case 0xAA: m.x = m.a; set_nz(m.x); break;
+    case 0x8A: m.a = m.x; set_nz(m.a); break;
+    case 0xA8: m.y = m.a; set_nz(m.y); break;
+    case 0x98: m.a = m.y; set_nz(m.a); break;
+    case 0xBA: m.x = m.s; set_nz(m.x); break;
+    case 0x9A: m.s = m.x; break;
+    case 0xE8: m.x++; set_nz(m.x); break;
+    case 0xCA: m.x--; set_nz(m.x); break;
+    case 0xC8: m.y++; set_nz(m.y); break;
+    case 0x88: m.y--; set_nz(m.y); break;
+
+    // Flags
+    case 0x18: m.p &= (uint8_t)~FLAG_C; break;
+    case 0x38: m.p |= FLAG_C; break;
+    case 0x58: m.p &= (uint8_t)~FLAG_I; break;
+    case 0x78: m.p |= FLAG_I; break;
+    case 0xB8: m.p &= (uint8_t)~FLAG_V; break;
+    case 0xD8: m.p &= (uint8_t)~FLAG_D; break;
+    case 0xF8: m.p |= FLAG_D; break;
+
+    // Stack
+    case 0x48: push(m.a); break;
+    case 0x08: push((uint8_t)(m.p | FLAG_B | FLAG_U)); break;
+    case 0x68: m.a = pull(); set_nz(m.a); break;
+    case 0x28: m.p = (uint8_t)((pull() & ~FLAG_B) | FLAG_U); break;
+
+    // Branches
+    case 0x10: branch(!(m.p & FLAG_N)); break;
+    case 0x30: branch(m.p & FLAG_N); break;
+    case 0x50: branch(!(m.p & FLAG_V)); break;
+    case 0x70: branch(m.p & FLAG_V); break;
+    case 0x90: branch(!(m.p & FLAG_C)); break;
+    case 0xB0: branch(m.p & FLAG_C); break;
+    case 0xD0: branch(!(m.p & FLAG_Z)); break;
+    case 0xF0: branch(m.p & FLAG_Z); break;
+
+    // Jumps
+    case 0x4C:
+        m.pc = fetch16();
+        break;
+    case 0x6C:
+        m.pc = read16_wrapped(fetch16());
+        break;
+    case 0x20:
+        addr = fetch16();
+        m.pc--;
+        push((uint8_t)(m.pc >> 8));
+        push((uint8_t)m.pc);
+        m.pc = addr;
+        break;
+    case 0x60:
+        m.pc = (uint16_t)(pull() | (pull() << 8));
+        m.pc++;
+        break;
+    case 0x40:
+        m.p = (uint8_t)((pull() & ~FLAG_B) | FLAG_U);
+        m.pc = (uint16_t)(pull() | (pull() << 8));
+        break;
+    case 0x00:
+        m.pc++;
+        interrupt(0xFFFE, 1);
+        break;
+    case 0xEA:
+        break;
+    default:
+        fail("unhandled opcode $%02X at $%04X", opcode, (uint16_t)(m.pc - 1));
+    }
+
+    advance(cycle_table[opcode] + extra_cycles);
+}
+
+// ------------------------------------------------------------------------
+// Machine setup
+
+static void reset_machine(int direct_boot)
+{
+    cia_reset(&m.cia1);
+    cia_reset(&m.cia2);
+    m.p = FLAG_I | FLAG_U;
+    m.s = 0xFF;
+    m.port_ddr = 0x2F;
+    m.port_data = 0x37;
+
+    if (direct_boot)
+    {
+        // Kernal defaults, with the internal function ROM at $8000
+        m.pcr[0] = 0x3F;
+        m.pcr[1] = 0x7F;
+        m.pcr[2] = 0x01;
+        m.pcr[3] = 0x41;
+        m.rcr = 0x04;
+        m.mcr = 0x01;
+        m.cr = 0x04;
+        m.pc = 0x8000;
+    }
+    else
+    {
+        m.cr = 0x00;
+        m.pc = read16(0xFFFC);
+    }
+}
+
+// ------------------------------------------------------------------------
+// Screen
+
+static char screen_char(uint8_t code)
+{
+    code &= 0x7F;
+    if (code == 0x00)
+        return '@';
+    if (code <= 26)
+        return (char)('a' + code - 1);
+    if (code >= 32 && code < 64)
+        return (char)code;
+    if (code >= 65 && code <= 90)
+        return (char)('A' + code - 65);
+    switch (code)
+    {
+    case 27: return '[';
+    case 29: return ']';
+    case 64: return '-';
+    case 91: return '+';
+    case 93: return '|';
+    case 100: return '_';
+    default: return '#';
+    }
+}
+
+static int vdc_active(void)
+{
+    return (m.ram[0][EDITOR_MODE] & 0x80) != 0;
+}
+
+// Render the active (or requested) display into rows of text
+static int render_screen(int use_vdc, char *text, size_t size)
+{
+    unsigned int columns = use_vdc ? 80 : 40;
+    unsigned int rows = 25;
+    unsigned int base;
+    unsigned int row, column;
+    size_t used = 0;
+    size_t row_start;
+
+    if (use_vdc)
+        base = (unsigned int)((m.vdc_reg[12] << 8) | m.vdc_reg[13]);
+    else
+        base = (unsigned int)((m.vic[0x18] >> 4) * 0x400);
+
+    for (row = 0; row < rows && used + columns + 2 < size; row++)
+    {
+        row_start = used;
+        for (column = 0; column < columns; column++)
+        {
+            unsigned int offset = row * columns + column;
+            uint8_t code = use_vdc ? m.vdc_ram[(base + offset) & 0xFFFF]
+                                   : m.ram[0][(base + offset) & 0xFFFF];
+
+            text[used++] = screen_char(code);
+        }
+        while (used > row_start && text[used - 1] == ' ')
+            used--;
+        text[used++] = '\n';
+    }
+    text[used] = '\0';
+    return (int)used;
+}
+
+// ------------------------------------------------------------------------
+// Script
+
+static int find_key(const char *name, uint8_t *column, uint8_t *row,
+                    uint8_t *shifted)
+{
+    size_t i;
+
+    for (i = 0; i < KEY_NAME_COUNT; i++)
+    {
+        if (strcmp(key_names[i].name, name) == 0)
+        {
+            *column = key_names[i].column;
+            *row = key_names[i].row;
+            *shifted = key_names[i].shifted;
+            return 1;
+        }
+    }
+    return 0;
+}
+
+static void hold(uint8_t column, uint8_t row)
+{
+    if (held_count < 4)
+    {
+        held_column[held_count] = column;
+        held_row[held_count] = row;
+        held_count++;
+    }
+    m.matrix[column] |= (uint8_t)(1 << row);
+}
+
+// Press one key (with SHIFT+/CTRL+/CBM+ modifiers) for KEY_HOLD_FRAMES
+static void press(const char *spec)
+{
+    char name[32];
+    uint8_t column, row, shifted;
+    const char *plus;
+
+    while ((plus = strchr(spec, '+')) != NULL && plus != spec)
+    {
+        snprintf(name, sizeof(name), "%.*s", (int)(plus - spec), spec);
+        if (!find_key(name, &column, &row, &shifted))
+            fail("unknown modifier %s", name);
+        hold(column, row);
+        spec = plus + 1;
+    }
+    if (!find_key(spec, &column, &row, &shifted))
+        fail("unknown key %s", spec);
+    if (shifted)
+        hold(1, 7);
+    hold(column, row);
+    release_tick = m.ticks + (uint64_t)KEY_HOLD_FRAMES * TICKS_PER_FRAME;
+}
+
+// Run until the menu waits for input again; 0 on timeout
+static int run_until_idle(unsigned int max_frames)
+{
+    uint64_t limit = m.ticks + (uint64_t)max_frames * TICKS_PER_FRAME;
+
+    watch_idle = 1;
+    idle_hit = 0;
+    while (!idle_hit && m.ticks < limit)
+        step();
+    watch_idle = 0;
+
+    // Let the key go before the next interaction starts
+    while (held_count)
+        step();
+    return idle_hit;
+}
+
+static void run_frames(unsigned int frames)
+{
+    uint64_t limit = m.ticks + (uint64_t)frames * TICKS_PER_FRAME;
+
+    while (m.ticks < limit)
+        step();
+}
+
+static void record(const char *keys, const char *label, uint64_t cycles,
+                   uint64_t ticks, int completed, unsigned int max_frames)
+{
+    struct interaction *entry;
+    double frames = (double)ticks / TICKS_PER_FRAME;
+
+    printf("interaction \"%s\" keys %s cycles %llu frames %.2f%s\n",
+           label, keys, (unsigned long long)cycles, frames,
+           completed ? "" : " TIMEOUT");
+    if (!completed || (max_frames && frames > max_frames))
+    {
+        printf("FAIL: \"%s\" exceeded %u frames\n", label, max_frames);
+        failures++;
+    }
+    if (interaction_count == MAX_INTERACTIONS)
+        return;
+    entry = &interactions[interaction_count++];
+    snprintf(entry->label, sizeof(entry->label), "%s", label);
+    snprintf(entry->keys, sizeof(entry->keys), "%s", keys);
+    entry->cycles = cycles;
+    entry->frames = frames;
+    entry->timed_out = !completed;
+}
+
+// Split "[max N] [label...]" off the rest of a command line
+static unsigned int parse_limit(char **rest)
+{
+    char *text = *rest;
+    unsigned int max_frames = 0;
+
+    while (*text == ' ')
+        text++;
+    if (strncmp(text, "max ", 4) == 0)
+    {
+        max_frames = (unsigned int)strtoul(text + 4, &text, 10);
+        while (*text == ' ')
+            text++;
+    }
+    *rest = text;
+    return max_frames;
+}
+
+static void command_key(char *args)
+{
+    char keys[64];
+    char *rest;
+    char *spec;
+    char *save;
+    char *star;
+    unsigned int max_frames;
+    unsigned int repeat;
+    uint64_t start_cycles = m.cycles;
+    uint64_t start_ticks = m.ticks;
+    int completed = 1;
+
+    rest = args;
+    while (*rest && *rest != ' ')
+        rest++;
+    snprintf(keys, sizeof(keys), "%.*s", (int)(rest - args), args);
+    max_frames = parse_limit(&rest);
+
+    for (spec = strtok_r(keys, ",", &save); spec != NULL;
+         spec = strtok_r(NULL, ",", &save))
+    {
+        repeat = 1;
+        star = strchr(spec, '*');
+        if (star != NULL)
+        {
+            *star = '\0';
+            repeat = (unsigned int)atoi(star + 1);
+        }
+        while (repeat--)
+        {
+            key_seen = 0;
+            press(spec);
+            if (!run_until_idle(max_frames ? max_frames : DEFAULT_IDLE_FRAMES))
+                completed = 0;
+        }
+        if (star != NULL)
+            *star = '*';
+    }
+
+    snprintf(keys, sizeof(keys), "%.*s", (int)strcspn(args, " "), args);
+    record(keys, *rest ? rest : keys, m.cycles - start_cycles,
+           m.ticks - start_ticks, completed, max_frames);
+}
+
+static void command_idle(char *args)
+{
+    unsigned int max_frames = parse_limit(&args);
+    uint64_t start_cycles = m.cycles;
+    uint64_t start_ticks = m.ticks;
+    int completed;
+
+    key_seen = 1;
+    completed = run_until_idle(max_frames ? max_frames : DEFAULT_IDLE_FRAMES);
+    record("-", *args ? args : "idle", m.cycles - start_cycles,
+           m.ticks - start_ticks, completed, max_frames);
+}
+
+static void command_expect(const char *text)
+{
+    static char screen[81 * 25 + 1];
+
+    render_screen(vdc_active(), screen, sizeof(screen));
+    if (strstr(screen, text) == NULL)
+    {
+        printf("FAIL: \"%s\" not on screen\n", text);
+        failures++;
+    }
+}
+
+static void command_dump(const char *which)
+{
+    static char screen[81 * 25 + 1];
+    int use_vdc = vdc_active();
+
+    if (strcmp(which, "vic") == 0)
+        use_vdc = 0;
+    else if (strcmp(which, "vdc") == 0)
+        use_vdc = 1;
+    render_screen(use_vdc, screen, sizeof(screen));
+    printf("screen %s\n%s", use_vdc ? "vdc" : "vic", screen);
+}
+
+static void command_serial(void)
+{
+    int i;
+    uint8_t byte;
+
+    printf("serial");
+    for (i = serial_reported; i < serial_count; i++)
+    {
+        byte = serial_bytes[i];
+        switch (byte & 0xF0)
+        {
+        case 0xA0:
+            printf(" $%02X(bank %u)", byte, byte & 0x0F);
+            break;
+        case 0xB0:
+            printf(" $%02X(jiffy %s)", byte, (byte & 0x01) ? "on" : "off");
+            break;
+        case 0xC0:
+            printf(" $%02X(bank high %u)", byte, byte & 0x0F);
+            break;
+        case 0xD0:
+            printf(" $%02X(temp bank %u)", byte, byte & 0x0F);
+            break;
+        case 0xE0:
+            printf(" $%02X(half %s)", byte,
+                   (byte & 0x0F) == 1 ? "lower" : "upper");
+            break;
+        default:
+            printf(" $%02X", byte);
+            break;
+        }
+    }
+    printf("\n");
+    serial_reported = serial_count;
+}
+
+static void run_script(FILE *script)
+{
+    char line[256];
+    char *command;
+    char *args;
+    size_t length;
+
+    while (fgets(line, sizeof(line), script) != NULL)
+    {
+        length = strcspn(line, "#\r\n");
+        line[length] = '\0';
+        while (length > 0 && isspace((unsigned char)line[length - 1]))
+            line[--length] = '\0';
+        command = line;
+        while (isspace((unsigned char)*command))
+            command++;
+        if (*command == '\0')
+            continue;
+        args = command + strcspn(command, " ");
+        if (*args)
+            *args++ = '\0';
+        while (*args == ' ')
+            args++;
+
+        if (strcmp(command, "key") == 0)
+            command_key(args);
+        else if (strcmp(command, "idle") == 0)
+            command_idle(args);
+        else if (strcmp(command, "wait") == 0)
+            run_frames((unsigned int)atoi(args));
+        else if (strcmp(command, "expect") == 0)
+            command_expect(args);
+        else if (strcmp(command, "dump") == 0)
+            command_dump(args);
+        else if (strcmp(command, "serial") == 0)
+            command_serial();
+        else if (strcmp(command, "ack") == 0)
+            ack_enabled = strcmp(args, "off") != 0;
+        else
+            fail("unknown script command %s", command);
+    }
+}
+
+static void write_report(const char *path)
+{
+    FILE *file;
+    int i;
+
+    file = fopen(path, "w");
+    if (file == NULL)
+        fail("cannot create %s", path);
+    fprintf(file, "{\n  \"display\": \"%s\",\n  \"interactions\": [\n",
+            col80 ? "vdc" : "vic");
+    for (i = 0; i < interaction_count; i++)
+    {
+        fprintf(file,
+                "    {\"label\": \"%s\", \"keys\": \"%s\", \"cycles\": %llu, "
+                "\"frames\": %.2f, \"timeout\": %s}%s\n",
+                interactions[i].label, interactions[i].keys,
+                (unsigned long long)interactions[i].cycles,
+                interactions[i].frames,
+                interactions[i].timed_out ? "true" : "false",
+                i + 1 < interaction_count ? "," : "");
+    }
+    fprintf(file, "  ]\n}\n");
+    if (fclose(file) != 0)
+        fail("cannot write %s", path);
+}
+
+int main(int argc, char **argv)
+{
+    const char *kernal_path = NULL;
+    const char *chargen_path = NULL;
+    const char *basic_lo_path = NULL;
+    const char *basic_hi_path = NULL;
+    const char *script_path = NULL;
+    const char *report_path = NULL;
+    const char *trace_path = NULL;
+    FILE *script = stdin;
+    int option;
+
+    while ((option = getopt(argc, argv, "k:c:b:B:8s:j:v:h")) != -1)
+    {
+        switch (option)
+        {
+        case 'k':
+            kernal_path = optarg;
+            break;
+        case 'c':
+            chargen_path = optarg;
+            break;
+        case 'b':
+            basic_lo_path = optarg;
+            break;
+        case 'B':
+            basic_hi_path = optarg;
+            break;
+        case '8':
+            col80 = 1;
+            break;
+        case 's':
+            script_path = optarg;
+            break;
+        case 'j':
+            report_path = optarg;
+            break;
+        case 'v':
+            trace_path = optarg;
+            break;
+        default:
+            usage();
+        }
+    }
+    if (kernal_path == NULL || optind + 1 != argc)
+        usage();
+    if ((basic_lo_path == NULL) != (basic_hi_path == NULL))
+        fail("%s", "-b and -B must be given together");
+
+    load_file(kernal_path, m.kernal, HALF_ROM_SIZE, HALF_ROM_SIZE);
+    if (chargen_path != NULL)
+        load_file(chargen_path, m.chargen, CHARGEN_SIZE, 0x1000);
+    if (basic_lo_path != NULL)
+    {
+        load_file(basic_lo_path, m.basic_lo, HALF_ROM_SIZE, HALF_ROM_SIZE);
+        load_file(basic_hi_path, m.basic_hi, HALF_ROM_SIZE, HALF_ROM_SIZE);
+    }
+    load_file(argv[optind], m.function_rom, ROM_SIZE, ROM_SIZE);
+
+    if (script_path != NULL)
+    {
+        script = fopen(script_path, "r");
+        if (script == NULL)
+            fail("cannot open %s", script_path);
+    }
+
+    reset_machine(basic_lo_path == NULL);
+    if (trace_path != NULL)
+    {
+        trace_open(trace_path);
+        trace_levels(trace_now());
+    }
+    run_script(script);
+    trace_close();
+    if (script != stdin)
+        fclose(script);
+
+    printf("total cycles %llu frames %.2f\n", (unsigned long long)m.cycles,
+           (double)m.ticks / TICKS_PER_FRAME);
+    if (report_path != NULL)
+        write_report(report_path);
+    return failures ? 1 : 0;
+}